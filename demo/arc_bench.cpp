@@ -0,0 +1,78 @@
+/**
+ * @file arc_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Arcs drawn per second by text_image across radii and spans
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "../include/text_image.hpp"
+
+using namespace g80;
+using image = text_image<int32_t, uint32_t>;
+
+/**
+ * arc_bench [seconds]
+ *
+ * Draws gfx_arc_color arcs on a 300x300 canvas for every pair of
+ * radius and span, each for at least seconds (0.25 by default),
+ * and prints the arcs per second. The start angle walks around the
+ * circle so that every octant is hit; spans past 360 degrees wrap
+ * into a second pass
+ *
+ */
+
+template<typename F>
+auto per_second(const double seconds, F &&draw) -> double {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t k = 0;
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < 256; ++i, ++k) draw(k);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return k / elapsed;
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    double seconds = argc >= 2 ? std::atof(argv[1]) : 0.25;
+    image canvas(300, 300, 0, ' ', OFF);
+
+    const int32_t radii[] {5, 20, 80, 140};
+    const int32_t spans[] {30, 90, 270, 400};
+
+    std::printf("arcs/s\n\nradius");
+    for (auto span : spans) std::printf("   span %3d", span);
+    std::printf("\n");
+
+    for (auto r : radii) {
+        std::printf("%6d", r);
+        for (auto span : spans) {
+            double arcs = per_second(seconds, [&](const uint32_t k) {
+                int32_t sa = static_cast<int32_t>(k % 360);
+                canvas.gfx_arc_color(150, 150, r, sa, sa + span, k & 7);});
+            std::printf(" %10.0f", arcs);
+        }
+        std::printf("\n");
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file blit_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief put_image and the boolean blits per second across sprite sizes
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "../include/text_image.hpp"
+
+using namespace g80;
+using image = text_image<int32_t, uint32_t>;
+
+/**
+ * blit_bench [seconds]
+ *
+ * Blits square sprites of random text, color and mask onto a
+ * 300x200 canvas with put_image, and_image, or_image and xor_image,
+ * each for at least seconds (0.25 by default), and prints the blits
+ * and the sprite cells per second.
+ *
+ * Inside places every sprite fully on the canvas; clipped places
+ * it across the left, right, top or bottom edge in turn
+ *
+ */
+
+template<typename F>
+auto per_second(const double seconds, F &&blit) -> double {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t k = 0;
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < 64; ++i, ++k) blit(k);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return k / elapsed;
+}
+
+auto random_image(const int32_t w, const int32_t h, std::mt19937 &rng) -> image {
+    image img(w, h, 0, ' ', OFF);
+    for (uint32_t i = 0; i < img.size(); ++i) {
+        img.set_text(i, 'A' + rng() % 26);
+        img.set_color(i, rng() % 8);
+        img.set_mask(i, rng() % 3 ? ON : OFF);
+    }
+    return img;
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    double seconds = argc >= 2 ? std::atof(argv[1]) : 0.25;
+    const int32_t W = 300, H = 200;
+
+    std::mt19937 rng(1);
+    image canvas = random_image(W, H, rng);
+
+    std::printf("size  placement     put/s       and/s        or/s       xor/s   put Mcells/s\n");
+    const int32_t sizes[] {1, 4, 13, 32, 70, 130};
+    for (auto sz : sizes) {
+        image sprite = random_image(sz, sz, rng);
+        double cells = static_cast<double>(sz) * sz;
+
+        for (int clipped = 0; clipped < 2; ++clipped) {
+            auto x_of = [&](const uint32_t k) -> int32_t {
+                if (!clipped) return (k * 7) % (W - sz + 1);
+                switch (k % 4) {
+                    case 0: return -sz / 2;
+                    case 1: return W - sz / 2;
+                    default: return (k * 7) % (W - sz + 1);
+                }
+            };
+            auto y_of = [&](const uint32_t k) -> int32_t {
+                if (!clipped) return (k * 11) % (H - sz + 1);
+                switch (k % 4) {
+                    case 2: return -sz / 2;
+                    case 3: return H - sz / 2;
+                    default: return (k * 11) % (H - sz + 1);
+                }
+            };
+
+            double put = per_second(seconds, [&](const uint32_t k) {canvas.put_image(x_of(k), y_of(k), sprite);});
+            double and_ = per_second(seconds, [&](const uint32_t k) {canvas.and_image(x_of(k), y_of(k), sprite);});
+            double or_ = per_second(seconds, [&](const uint32_t k) {canvas.or_image(x_of(k), y_of(k), sprite);});
+            double xor_ = per_second(seconds, [&](const uint32_t k) {canvas.xor_image(x_of(k), y_of(k), sprite);});
+            std::printf("%4d  %-9s %11.0f %11.0f %11.0f %11.0f %12.1f\n",
+                sz, clipped ? "clipped" : "inside", put, and_, or_, xor_, put * cells / 1e6);
+        }
+    }
+}
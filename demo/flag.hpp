@@ -27,6 +27,7 @@
 
 #include <array>
 #include "../include/text_video_anim.hpp"
+#include "../include/text_image_ring.hpp"
 
 using namespace g80;
 
@@ -77,8 +78,7 @@ public:
             }
         }
 
-        pinoy_flag_.gfx_circle_color(14, 15, 6, 3);
-        pinoy_flag_.gfx_fill_color(14, 15, 3);
+        pinoy_flag_.gfx_circle_fill_color(14, 15, 6, 3);
         for (double i = 0.0; i < 2.0 * M_PI; i += 2.0 * M_PI / 8.0) {
             pinoy_flag_.set_color(static_cast<int_type>(14.0 + 7.0 * cos(i)), static_cast<int_type>(15.0 + 7.0 * sin(i)), 3);
             pinoy_flag_.set_color(static_cast<int_type>(14.0 + 8.0 * cos(i)), static_cast<int_type>(15.0 + 8.0 * sin(i)), 3);
@@ -95,6 +95,7 @@ public:
     auto preprocess() -> bool {
         preprocess_wave_values();
         preprocess_flag_drawing();
+        pinoy_flag_ring_.reset(pinoy_flag_, COLOR);
         update();
         return true;
     }
@@ -102,11 +103,10 @@ public:
     auto update() -> bool {
 
         screen_.fill_text(' ');
-        pinoy_flag_.xlat_rotate_right(flag_width - 1, COLOR);
+        pinoy_flag_ring_.rotate_right(flag_width - 1);
 
         for (int_type x = 0; x < static_cast<int_type>(flag_width); ++x) {
-            text_image<int_type, uint_type> vertical_line = pinoy_flag_.get_image(x, 0, 1, flag_height);
-            screen_.put_image(x, wave_height / 2  + wave_y_[x], vertical_line);
+            screen_.put_image(x, wave_height / 2  + wave_y_[x], pinoy_flag_ring_.get_image_view(x, 0, 1, flag_height));
             wave_y_[x] = wave_y_[x] + wave_yn_[x];
             if (wave_y_[x] <= 0) {wave_y_[x] = 1; wave_yn_[x] = 1;} 
             else if (wave_y_[x] >= wave_height - 1) {wave_y_[x] = wave_height - 2; wave_yn_[x] = -1;} 
@@ -118,6 +118,7 @@ public:
 private:
 
     text_image<int_type, uint_type> pinoy_flag_;
+    text_image_ring<int_type, uint_type> pinoy_flag_ring_;
     std::array<int_type, flag_width> wave_y_;
     std::array<uint_type, flag_width> wave_yn_;
 };
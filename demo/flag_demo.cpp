@@ -22,11 +22,34 @@
  * 
  */
 
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 #include "flag.hpp"
+#include "../include/text_frame_capture.hpp"
+
+// flag_demo --headless frames [file] runs without the terminal,
+// as fast as it goes, optionally saving every frame to file
 
 auto main(const int argc, const char *argv[]) -> int {
     flag pinoy_flag; 
     pinoy_flag.preprocess();
+
+    if (argc >= 3 && std::string(argv[1]) == "--headless") {
+        std::size_t frames = std::strtoull(argv[2], nullptr, 10);
+
+        auto start = std::chrono::steady_clock::now();
+        if (argc >= 4) {
+            text_frame_file<int_type, uint_type> file(argv[3]);
+            pinoy_flag.run_headless(frames, file);
+        } else {
+            pinoy_flag.run_headless(frames);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << frames << " frames in " << ms << " ms (" << frames * 1000.0 / ms << " frames/s)\n";
+        return 0;
+    }
+
     pinoy_flag.run();
 }
-
@@ -0,0 +1,80 @@
+/**
+ * @file gfx_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Lines, circles, arcs and flood fills drawn per second by text_image
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "../include/text_image.hpp"
+
+using namespace g80;
+using image = text_image<int16_t, uint16_t>;
+
+/**
+ * gfx_bench [seconds]
+ *
+ * Draws each primitive on a 200x120 canvas over and over for at
+ * least seconds (0.5 by default) and prints how many were drawn
+ * per second. Only the public gfx_* calls are used, so the same
+ * file builds against older trees to compare before and after
+ *
+ */
+
+template<typename F>
+auto per_second(const double seconds, F &&draw) -> double {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t k = 0;
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < 256; ++i, ++k) draw(k);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return k / elapsed;
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    double seconds = argc >= 2 ? std::atof(argv[1]) : 0.5;
+    image canvas(200, 120, 0, ' ', OFF);
+
+    auto print = [](const char *name, const double n) {std::printf("%-28s %12.0f /s\n", name, n);};
+
+    print("gfx_line", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_line(k % 190, (k * 7) % 110, (k * 13) % 190, (k * 3) % 110, k % 8, 'a' + k % 26, k & 1 ? ON : OFF);}));
+    print("gfx_line_color", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_line_color(k % 190, (k * 7) % 110, (k * 13) % 190, (k * 3) % 110, k % 8);}));
+    print("gfx_circle r 1-50", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_circle(100, 60, k % 50 + 1, k % 8, 'A' + k % 26, k & 2 ? ON : OFF);}));
+    print("gfx_circle_text r 1-50", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_circle_text(100, 60, k % 50 + 1, 'a' + k % 26);}));
+    print("gfx_arc r 1-50", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_arc(100, 60, k % 50 + 1, (k * 17) % 360, (k * 17) % 360 + k % 400, k % 8, '0' + k % 10, ON);}));
+    print("gfx_arc_mask r 1-50", per_second(seconds, [&](const uint32_t k) {
+        canvas.gfx_arc_mask(100, 60, k % 50 + 1, (k * 17) % 360, (k * 17) % 360 + k % 400, k & 1 ? ON : OFF);}));
+
+    // Refills the inside of a circle of radius 40, about 5000 cells
+    image disc(100, 100, 0, ' ', OFF);
+    disc.gfx_circle_color(50, 50, 40, 1);
+    print("gfx_fill_color r 40", per_second(seconds, [&](const uint32_t k) {
+        disc.gfx_fill_color(50, 50, 2 + k % 2);}));
+}
@@ -25,13 +25,36 @@
 #ifndef GOL_HPP
 #define GOL_HPP
 
+#include <cstdlib>
 #include <ctime>
-#include <tuple>
+#include <vector>
 #include "gol_common.hpp"
-#include "gol_bounds.hpp"
-#include "gol_creatures.hpp"
 #include "../include/text_video_anim.hpp"
 
+/**
+ * Uncomment #define GOL_BITBOARD to step the board as packed
+ * 64-bit bitboards instead of hash sets of creatures
+ *
+ * #define GOL_BITBOARD
+ *
+ */
+
+/**
+ * Or uncomment #define GOL_RULE to play any rulestring that gol_rule
+ * takes (B/S, Generations or Larger than Life) instead of Life
+ *
+ * #define GOL_RULE "B36/S23"
+ *
+ */
+
+#if defined(GOL_RULE)
+#include "gol_rule_board.hpp"
+#elif defined(GOL_BITBOARD)
+#include "gol_bitboard.hpp"
+#else
+#include "gol_hash.hpp"
+#endif
+
 using namespace g80;
 
 /**
@@ -45,8 +68,15 @@ constexpr uint_type SCREEN_HEIGHT = 30;
 constexpr uint_type SCREEN_SIZE = SCREEN_WIDTH * SCREEN_HEIGHT;
 constexpr uint_type FPS = 5;
 constexpr uint_type STARTING_CREATURES = 2000;
+constexpr gol_topology TOPOLOGY = BOUNDED;
 
-using SCR_BND = gol_bounds<int_type, uint_type, SCREEN_WIDTH, SCREEN_HEIGHT>;
+#if defined(GOL_RULE)
+using gol_engine = gol_rule_board<uint_type>;
+#elif defined(GOL_BITBOARD)
+using gol_engine = gol_bitboard<uint_type>;
+#else
+using gol_engine = gol_hash<SCREEN_WIDTH, SCREEN_HEIGHT, TOPOLOGY>;
+#endif
 
 /**
  * Game of Life Class Proper
@@ -65,15 +95,21 @@ class gol : public text_video_anim<int_type, uint_type> {
 
 private:
 
-    gol_creatures<uint_type> live_creatures_;
-    gol_creatures<uint_type> potential_creatures_;
+    gol_engine engine_;
+    unsigned int seed_;
 
 public:
     
-    gol() : 
+    // A fixed seed gives the same run every time
+
+    gol(const unsigned int seed = static_cast<unsigned int>(time(NULL))) : 
         text_video_anim<int_type, uint_type>(SCREEN_WIDTH, SCREEN_HEIGHT, FPS),
-        live_creatures_(SCREEN_WIDTH, SCREEN_HEIGHT),
-        potential_creatures_(SCREEN_WIDTH, SCREEN_HEIGHT) {
+        #if defined(GOL_RULE)
+        engine_(SCREEN_WIDTH, SCREEN_HEIGHT, gol_rule(GOL_RULE)),
+        #else
+        engine_(SCREEN_WIDTH, SCREEN_HEIGHT),
+        #endif
+        seed_(seed) {
 
         }
     
@@ -87,137 +123,39 @@ public:
 
 private: 
 
-    auto preprocess_random_creatures(const uint_type n) -> uoset_ix {
-        srand(time(NULL));
-        uoset_ix random_creatures;
+    auto preprocess_random_creatures(const uint_type n) -> std::vector<uint_type> {
+        srand(seed_);
         std::vector<uint_type> live_creatures;
         live_creatures.reserve(screen_.size());
         for (uint_type i = 0; i < screen_.size(); ++i) live_creatures.emplace_back(i);
         for (uint_type i = 0; i < screen_.size(); ++i) std::swap(live_creatures[i], live_creatures[rand() % screen_.size()]);
-        for (uint_type i = 0; i < n; ++i) random_creatures.insert(live_creatures[i]);
-        return random_creatures;
+        return std::vector<uint_type>(live_creatures.begin(), live_creatures.begin() + n);
     }
 
 
     auto update_erase_creatures() -> void {
-        for (auto &c : live_creatures_.get_creature_count()) 
-            screen_.set_text(c.first, ' ');
-    }
-
-    auto update_execute_rules_get_vars() -> std::tuple<uoset_ix, uoset_ix, uoset_ix> {
-        
-        uoset_ix to_get_neighbors;
-        uoset_ix to_update_count;
-        uoset_ix to_spawn;
-
-        for (uint_type group{0}; group <= 8; ++group) {
-            
-            // Spaces with 3 neighbors 
-            // will be spawned
-            if (group == 3) {
-                for (auto ix : potential_creatures_.get_grouped_creatures(group)) {
-                    to_spawn.insert(ix);
-                    to_get_neighbors.insert(ix);
-                }
-                potential_creatures_.kill_group(group);
-            
-            // Creatures with 2 neighbors will remain
-            // but the count needs to get updated
-            } else if (group == 2) {
-                for (auto &ix : live_creatures_.get_grouped_creatures(group)) 
-                    to_update_count.insert(ix);
-
-
-            // Under population (0, 1) and 
-            // over population (4, 5, 6, 7, 8) will be killed
-            } else {
-                for (auto &ix : live_creatures_.get_grouped_creatures(group)) 
-                    to_get_neighbors.insert(ix);
-
-                live_creatures_.kill_group(group);
-            }
-        }
-
-        return {to_get_neighbors, to_update_count, to_spawn};
+        engine_.for_each_creature([&](const uint_type ix, const uint_type) {
+            screen_.set_text(ix, ' ');
+        });
     }
 
-    auto update_execute_rules() -> void {
-
-        std::tuple<uoset_ix, uoset_ix, uoset_ix> vars = update_execute_rules_get_vars();
-        uoset_ix &to_get_neighbors = std::get<0>(vars);
-        uoset_ix &to_update_count = std::get<1>(vars);
-        uoset_ix &to_spawn = std::get<2>(vars);
-
-        // Recalc neighbors
-        uint_type count;
-        uoset_ix additional_to_update_count;
-        std::function<auto (const uint_type) -> bool> if_always_true = [](const uint_type) {return true;};
-        std::function<auto (const uint_type) -> bool> if_bound_exists = [&](const uint_type ix) {return live_creatures_.exists(ix);};
-        std::function<auto (const uint_type) -> void> then_add_to_update_count = [&](const uint_type ix) {to_update_count.insert(ix);};
-        std::function<auto (const uint_type) -> void> then_inc_count = [&](const uint_type ix) {++count;};
-        
-        for (auto &s : to_spawn) {
-            count = 0;
-            SCR_BND::get_instance().iterate(s, if_bound_exists, then_inc_count, nullptr);
-            live_creatures_.update(s, count);
-        }
-        
-        for (auto &n : to_get_neighbors) 
-            SCR_BND::get_instance().iterate(n, if_always_true, then_add_to_update_count, nullptr);
-        
-        for (auto &n : additional_to_update_count) 
-            to_update_count.insert(n);
-        
-        for (auto &ix : to_update_count) {
-            count = 0;
-            SCR_BND::get_instance().iterate(ix, if_bound_exists, then_inc_count, nullptr);
-
-            if (live_creatures_.exists(ix)) {
-                live_creatures_.update(ix, count);
-            } else if (count == 3) {
-                potential_creatures_.update(ix, count);
-            }
-        } 
-    }
-    
     auto update_render_creatures() -> void {
-        for (auto &c : live_creatures_.get_creature_count()) {
-            screen_.set_color(c.first, 1 + c.second % 7);
-            screen_.set_text(c.first, '0' + c.second);
-        }
+        engine_.for_each_creature([&](const uint_type ix, const uint_type count) {
+            screen_.set_color(ix, 1 + count % 7);
+            screen_.set_text(ix, '0' + count % 10);
+        });
     }
 
 public:
 
     auto preprocess() -> bool {
-        uoset_ix live = preprocess_random_creatures(STARTING_CREATURES);
-        uoset_ix potential;
-
-        uint_type count;
-        using fparameter_bool = std::function<auto (const uint_type ix) -> bool>;
-        using fparameter_void = std::function<auto (const uint_type ix) -> void>;
-        fparameter_bool if_exists = [&](const uint_type ix) -> bool {auto f = live.find(ix); return f != live.end();};
-        fparameter_void then_inc_count = [&](const uint_type ix) -> void {++count;};
-        fparameter_void else_add_to_potential = [&](const uint_type ix) -> void {potential.insert(ix);};
-
-        for (auto &ix : live) {
-            count = 0;
-            SCR_BND::get_instance().iterate(ix, if_exists, then_inc_count, else_add_to_potential);
-            live_creatures_.update(ix, count);
-        }
-
-        for (auto &ix : potential) {
-            count = 0;
-            if (ix < screen_.size()) SCR_BND::get_instance().iterate(ix, if_exists, then_inc_count, nullptr);
-            if (count == 3) potential_creatures_.update(ix, count);
-        }
-
+        engine_.reset(preprocess_random_creatures(STARTING_CREATURES));
         return true;
     }
 
     auto update() -> bool {
         update_erase_creatures();
-        update_execute_rules();
+        engine_.step();
         update_render_creatures();
         return true;
     }
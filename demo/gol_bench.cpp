@@ -0,0 +1,93 @@
+/**
+ * @file gol_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Generations per second of the gol_hash and gol_bitboard engines
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "gol_bitboard.hpp"
+#include "gol_hash.hpp"
+
+using namespace g80;
+
+/**
+ * gol_bench [seconds]
+ *
+ * Steps each engine for at least seconds (1 by default) and prints
+ * the generations per second of step() alone. The board is seeded
+ * with a third of its cells alive and seeded again every 100
+ * generations, outside of the time taken, so that the soup is still
+ * active rather than settled into tiles the bitboard skips.
+ *
+ * gol_hash numbers its cells with uint16_t and is sized at
+ * compile time, so it runs only at 130x30, the demo's board
+ *
+ */
+
+template<typename cell_type>
+auto random_board(const uint64_t size) -> std::vector<cell_type> {
+    std::mt19937 rng(7);
+    std::vector<cell_type> live;
+    live.reserve(size / 3 + 1);
+    for (uint64_t i = 0; i < size; ++i) if (rng() % 3 == 0) live.push_back(static_cast<cell_type>(i));
+    return live;
+}
+
+constexpr uint64_t GENERATIONS_PER_SEED = 100;
+
+template<typename engine_type, typename cell_type>
+auto generations_per_second(engine_type &engine, const std::vector<cell_type> &board, const double seconds) -> double {
+    uint64_t generations = 0;
+    double elapsed = 0;
+    do {
+        engine.reset(board);
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < GENERATIONS_PER_SEED; ++i) engine.step();
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        generations += GENERATIONS_PER_SEED;
+    } while (elapsed < seconds);
+    return generations / elapsed;
+}
+
+auto print(const char *engine, const uint32_t w, const uint32_t h, const double gps) -> void {
+    std::printf("%-10s %5ux%-5u %12.1f gen/s %8.2f Gcell/s\n", engine, w, h, gps, gps * w * h / 1e9);
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    double seconds = argc >= 2 ? std::atof(argv[1]) : 1.0;
+
+    {
+        gol_hash<130, 30> engine(130, 30);
+        print("hash", 130, 30, generations_per_second(engine, random_board<uint16_t>(130 * 30), seconds));
+    }
+
+    const uint32_t sizes[][2] {{130, 30}, {1024, 1024}, {8192, 8192}};
+    for (auto size : sizes) {
+        uint32_t w = size[0], h = size[1];
+        gol_bitboard<uint32_t> engine(w, h);
+        print("bitboard", w, h, generations_per_second(engine, random_board<uint32_t>(static_cast<uint64_t>(w) * h), seconds));
+    }
+}
@@ -0,0 +1,282 @@
+/**
+ * @file gol_bitboard.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Game of Life engine that steps the whole board as packed 64-bit bitboards
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Cell (x, y) is bit x % 64 of word x / 64 of row y. Every row is padded
+ * with a zero word on both sides and the board with a zero row above and
+ * below, so cells past the edges are always dead and the inner loop never
+ * branches on the border.
+ *
+ * The 8 neighbors of 64 cells are added at once with full adders on whole
+ * words (bit-slicing). The sum is kept as four bit planes of weight 1, 2,
+ * 4 and 8, from which both the next generation and the per-cell neighbor
+ * count are read.
+ *
+ * A generation is stepped in tiles of tile_rows x tile_words words, 64
+ * rows of one cache line each. A tile writes only its own words of the
+ * next board and reads its halo (the row above, the row below and the
+ * word on either side) straight from the current board, which no tile
+ * writes to. Tiles are therefore independent and are spread over a
+ * thread pool; the boards are swapped once all of them are done.
+ *
+ * A tile is stable when the step left its words equal to what they were
+ * two generations ago, which covers still lifes and period 2 oscillators.
+ * If a tile and its 8 neighbors were all stable in the last step, the
+ * next board already holds its next generation and the tile is skipped.
+ * A tile written through set() or reset() is never stable in the step
+ * that follows, since its older generation is no longer its ancestor.
+ *
+ */
+
+#ifndef GOL_BITBOARD_HPP
+#define GOL_BITBOARD_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "gol_rule.hpp"
+#include "gol_thread_pool.hpp"
+
+template<typename uint_type, typename rule_type = gol_rule_life>
+class gol_bitboard {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+public:
+
+    static constexpr std::size_t tile_rows = 64;
+    static constexpr std::size_t tile_words = 8;
+
+private:
+
+    uint_type w_, h_;
+    std::size_t words_per_row_, stride_;
+    std::size_t tiles_per_row_, tiles_per_col_;
+    uint64_t last_word_mask_;
+    std::vector<uint64_t> curr_, next_;
+    std::vector<uint8_t> is_stable_, next_is_stable_, is_touched_;
+    std::vector<std::size_t> active_tiles_;
+    std::size_t tiles_processed_{0};
+    rule_type rule_;
+    gol_thread_pool pool_;
+
+public:
+
+    gol_bitboard(const uint_type w, const uint_type h, const std::size_t threads = 1, const rule_type &rule = rule_type()) :
+        w_(w), h_(h),
+        words_per_row_((static_cast<std::size_t>(w) + 63) / 64),
+        stride_(words_per_row_ + 2),
+        tiles_per_row_((words_per_row_ + tile_words - 1) / tile_words),
+        tiles_per_col_((static_cast<std::size_t>(h) + tile_rows - 1) / tile_rows),
+        last_word_mask_(w % 64 ? (uint64_t{1} << (w % 64)) - 1 : ~uint64_t{0}),
+        curr_(stride_ * (static_cast<std::size_t>(h) + 2), 0),
+        next_(stride_ * (static_cast<std::size_t>(h) + 2), 0),
+        is_stable_(tiles(), 0),
+        next_is_stable_(tiles(), 0),
+        is_touched_(tiles(), 1),
+        rule_(rule),
+        pool_(threads) {
+
+        active_tiles_.reserve(tiles());
+    }
+
+    ~gol_bitboard() = default;
+
+/**
+ * Public Interfaces
+ *
+ */
+
+public:
+
+    inline auto width() const -> uint_type {
+        return w_;
+    }
+
+    inline auto height() const -> uint_type {
+        return h_;
+    }
+
+    inline auto tiles() const -> std::size_t {
+        return tiles_per_row_ * tiles_per_col_;
+    }
+
+    // Tiles stepped by the last call to step()
+
+    inline auto tiles_processed() const -> std::size_t {
+        return tiles_processed_;
+    }
+
+    inline auto threads() const -> std::size_t {
+        return pool_.size();
+    }
+
+    auto size() const -> std::size_t {
+        std::size_t n = 0;
+        for (auto word : curr_) n += __builtin_popcountll(word);
+        return n;
+    }
+
+    inline auto exists(const uint_type x, const uint_type y) const -> bool {
+        return (curr_[word_ix(x, y)] >> (x % 64)) & 1;
+    }
+
+    inline auto set(const uint_type x, const uint_type y, const bool is_alive) -> void {
+        uint64_t bit = uint64_t{1} << (x % 64);
+        std::size_t t = tile_ix(x, y);
+        is_stable_[t] = 0;
+        is_touched_[t] = 1;
+        if (is_alive) curr_[word_ix(x, y)] |= bit;
+        else curr_[word_ix(x, y)] &= ~bit;
+    }
+
+    template<typename ix_container_type>
+    auto reset(const ix_container_type &live) -> void {
+        std::fill(curr_.begin(), curr_.end(), 0);
+        std::fill(is_stable_.begin(), is_stable_.end(), 0);
+        std::fill(is_touched_.begin(), is_touched_.end(), 1);
+        for (auto ix : live)
+            if (ix < static_cast<std::size_t>(w_) * h_) set(ix % w_, ix / w_, true);
+    }
+
+    // Applies rule_type to every cell, B3/S23 unless
+    // another rule was given
+
+    auto step() -> void {
+        active_tiles_.clear();
+        for (std::size_t t = 0; t < tiles(); ++t) {
+            if (is_active(t)) active_tiles_.push_back(t);
+            else next_is_stable_[t] = 1;
+        }
+
+        pool_.run(active_tiles_.size(), [this](const std::size_t i) {step_tile(active_tiles_[i]);});
+        tiles_processed_ = active_tiles_.size();
+
+        curr_.swap(next_);
+        is_stable_.swap(next_is_stable_);
+    }
+
+    // Calls each_creature(ix, count) for every
+    // live creature and its neighbor count
+
+    template<typename each_creature_type>
+    auto for_each_creature(const each_creature_type &each_creature) const -> void {
+        for (uint_type y = 0; y < h_; ++y) {
+            const uint64_t *curr = &curr_[word_ix(0, y)];
+            for (std::size_t k = 0; k < words_per_row_; ++k) {
+                uint64_t live = curr[k];
+                if (!live) continue;
+                gol_count_planes c = count_neighbors(&curr[k]);
+                std::size_t ix = static_cast<std::size_t>(y) * w_ + k * 64;
+                while (live) {
+                    uint_fast8_t bit = static_cast<uint_fast8_t>(__builtin_ctzll(live));
+                    each_creature(static_cast<uint_type>(ix + bit), c.count(bit));
+                    live &= live - 1;
+                }
+            }
+        }
+    }
+
+private:
+
+    inline auto word_ix(const uint_type x, const uint_type y) const -> std::size_t {
+        return (static_cast<std::size_t>(y) + 1) * stride_ + 1 + x / 64;
+    }
+
+    inline auto tile_ix(const uint_type x, const uint_type y) const -> std::size_t {
+        return (y / tile_rows) * tiles_per_row_ + x / 64 / tile_words;
+    }
+
+    auto is_active(const std::size_t t) const -> bool {
+        std::size_t tx = t % tiles_per_row_, ty = t / tiles_per_row_;
+        std::size_t sx = tx > 0 ? tx - 1 : 0, ex = std::min(tx + 2, tiles_per_row_);
+        std::size_t sy = ty > 0 ? ty - 1 : 0, ey = std::min(ty + 2, tiles_per_col_);
+        for (std::size_t y = sy; y < ey; ++y)
+            for (std::size_t x = sx; x < ex; ++x)
+                if (!is_stable_[y * tiles_per_row_ + x]) return true;
+        return false;
+    }
+
+    auto step_tile(const std::size_t t) -> void {
+        std::size_t sy = (t / tiles_per_row_) * tile_rows;
+        std::size_t ey = std::min(sy + tile_rows, static_cast<std::size_t>(h_));
+        std::size_t sk = (t % tiles_per_row_) * tile_words;
+        std::size_t ek = std::min(sk + tile_words, words_per_row_);
+
+        uint64_t diff = 0;
+        for (std::size_t y = sy; y < ey; ++y) {
+            const uint64_t *curr = &curr_[word_ix(0, static_cast<uint_type>(y))];
+            uint64_t *next = &next_[word_ix(0, static_cast<uint_type>(y))];
+            for (std::size_t k = sk; k < ek; ++k) {
+                gol_count_planes c = count_neighbors(&curr[k]);
+                uint64_t n = rule_(curr[k], c);
+                if (k == words_per_row_ - 1) n &= last_word_mask_;
+                diff |= next[k] ^ n;
+                next[k] = n;
+            }
+        }
+
+        next_is_stable_[t] = !diff && !is_touched_[t];
+        is_touched_[t] = 0;
+    }
+
+    // Sum of a, b and c as (sum, carry)
+
+    static inline auto full_add(const uint64_t a, const uint64_t b, const uint64_t c, uint64_t &carry) -> uint64_t {
+        uint64_t t = a ^ b;
+        carry = (a & b) | (t & c);
+        return t ^ c;
+    }
+
+    // Adds the 8 neighbors of the 64 cells in *p, using
+    // the words beside it and the rows above and below
+
+    inline auto count_neighbors(const uint64_t *p) const -> gol_count_planes {
+        const uint64_t *u = p - stride_;
+        const uint64_t *d = p + stride_;
+
+        // Per row: west, east and for the outer rows the center
+        uint64_t u1, m1, d1;
+        uint64_t u0 = full_add((u[0] << 1) | (u[-1] >> 63), u[0], (u[0] >> 1) | (u[1] << 63), u1);
+        uint64_t mw = (p[0] << 1) | (p[-1] >> 63);
+        uint64_t me = (p[0] >> 1) | (p[1] << 63);
+        uint64_t m0 = mw ^ me;
+        m1 = mw & me;
+        uint64_t d0 = full_add((d[0] << 1) | (d[-1] >> 63), d[0], (d[0] >> 1) | (d[1] << 63), d1);
+
+        // Weight 1, then the four weight 2 bits
+        uint64_t c2, c4, c4b;
+        uint64_t p1 = full_add(u0, m0, d0, c2);
+        uint64_t s2 = full_add(u1, m1, d1, c4);
+        uint64_t p2 = s2 ^ c2;
+        c4b = s2 & c2;
+
+        return {p1, p2, c4 ^ c4b, c4 & c4b};
+    }
+};
+
+#endif
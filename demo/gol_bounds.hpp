@@ -25,81 +25,104 @@
 #ifndef GOL_BOUNDS_HPP
 #define GOL_BOUNDS_HPP
 
-#include <functional>
+#include <array>
 #include "gol_common.hpp"
 
-using fparameter_bool = std::function<auto (const uint_type) -> bool>;
-using fparameter_void = std::function<auto (const uint_type) -> void>;
-
 /**
- * A singleton template for 
- * processing indexes and its boundaries
- * 
+ * Compile-time neighborhood of a w x h board
+ *
+ * Interior cells reach their 8 neighbors through fixed offsets, with no
+ * test per neighbor. Cells on the edges take a separate path that maps
+ * each neighbor through the topology.
+ *
  */
 
-template<typename int_type, typename uint_type, uint_type w, uint_type h>
+template<typename int_type, typename uint_type, uint_type w, uint_type h, gol_topology topology = BOUNDED>
 class gol_bounds {
 
 /**
- * Constructors, Assignments and 
- * Instance
- * 
+ * Tables
+ *
  */
 
-private:
+public:
+
+    static constexpr uint_type size = w * h;
+
+    static constexpr std::array<int_type, 8> offsets {
+        static_cast<int_type>(-w - 1), static_cast<int_type>(-w), static_cast<int_type>(-w + 1),
+        -1, +1,
+        static_cast<int_type>(w - 1), static_cast<int_type>(w), static_cast<int_type>(w + 1)};
 
-    static uint_type size_;
-    static std::array<int_type, 8> ref_bounds_;
+    static constexpr std::array<int_type, 8> dx {-1, 0, 1, -1, 1, -1, 0, 1};
+    static constexpr std::array<int_type, 8> dy {-1, -1, -1, 0, 0, 1, 1, 1};
 
 private:
 
-    gol_bounds() {}
+    gol_bounds() = delete;
 
-public:
+/**
+ * Public Interface
+ *
+ */
 
-    gol_bounds(const gol_bounds &) = delete;
-    auto operator=(const gol_bounds &) -> gol_bounds & = delete;
+public:
 
-    static auto get_instance() -> gol_bounds & {
-        static gol_bounds<int_type, uint_type, w, h> instance;
-        return instance;
+    static constexpr auto is_out_of_bounds(const uint_type ix) -> bool {
+        return ix >= size;
     }
 
+    static constexpr auto is_interior(const uint_type ix) -> bool {
+        uint_type x = ix % w, y = ix / w;
+        return x > 0 && x < w - 1 && y > 0 && y < h - 1;
+    }
 
-/**
- * Public Interface
- * 
- */
+    // Calls each_neighbor(i) once per neighbor of ix
 
-public: 
-
-    auto is_out_of_bounds(const uint_type ix) -> bool {return ix >= size_;}
-
-    auto iterate(
-        const uint_type ix, 
-        const fparameter_bool &condition,
-        const fparameter_void &if_action,
-        const fparameter_void &else_action) -> void {
-        
-        if (!if_action) return;
-        for (auto &r : ref_bounds_) {
-            uint_type i = ix + r; 
-            if (condition(i)) if_action(i); 
-            else if (else_action) else_action(i);
+    template<typename each_neighbor_type>
+    static inline auto for_each_neighbor(const uint_type ix, const each_neighbor_type &each_neighbor) -> void {
+        if (is_interior(ix)) {
+            for (auto o : offsets) each_neighbor(static_cast<uint_type>(ix + o));
+        } else {
+            for_each_edge_neighbor(ix, each_neighbor);
         }
     }
-};
 
-/**
- * Static vars instantiation
- * per template
- * 
- */
+    // Number of neighbors of ix for which is_alive(i) is true
 
-template<typename int_type, typename uint_type, uint_type w, uint_type h>
-uint_type gol_bounds<int_type, uint_type, w, h>::size_ = w * h;
+    template<typename is_alive_type>
+    static inline auto count(const uint_type ix, const is_alive_type &is_alive) -> uint_type {
+        uint_type n = 0;
+        if (is_interior(ix)) {
+            for (auto o : offsets) n += is_alive(static_cast<uint_type>(ix + o)) ? 1 : 0;
+        } else {
+            for_each_edge_neighbor(ix, [&](const uint_type i) {n += is_alive(i) ? 1 : 0;});
+        }
+        return n;
+    }
+
+private:
 
-template<typename int_type, typename uint_type, uint_type w, uint_type h>
-std::array<int_type, 8> gol_bounds<int_type, uint_type, w, h>::ref_bounds_ = {- w, - w - 1, - w + 1, - 1, + 1, + w, + w - 1, + w + 1};
+    template<typename each_neighbor_type>
+    static auto for_each_edge_neighbor(const uint_type ix, const each_neighbor_type &each_neighbor) -> void {
+        const int_type x = static_cast<int_type>(ix % w), y = static_cast<int_type>(ix / w);
+        for (uint_type k = 0; k < 8; ++k) {
+            int32_t nx = x + dx[k], ny = y + dy[k];
+
+            if constexpr (topology == BOUNDED) {
+                if (nx < 0 || nx >= static_cast<int32_t>(w) || ny < 0 || ny >= static_cast<int32_t>(h)) continue;
+            } else {
+                if (ny < 0 || ny >= static_cast<int32_t>(h)) {
+                    ny = ny < 0 ? ny + h : ny - h;
+                    if constexpr (topology == KLEIN) nx = static_cast<int32_t>(w) - 1 - nx;
+                }
+                if (nx < 0) nx += w;
+                else if (nx >= static_cast<int32_t>(w)) nx -= w;
+            }
+
+            each_neighbor(static_cast<uint_type>(ny * w + nx));
+        }
+    }
+};
 
-#endif
\ No newline at end of file
+#endif
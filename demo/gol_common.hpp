@@ -26,13 +26,19 @@
 #define GOL_COMMON_HPP
 
 #include <cstdint>
-#include <unordered_map>
-#include <unordered_set>
 
 using int_type = int16_t;
 using uint_type = uint16_t;
 
-using uoset_ix = std::unordered_set<uint_type>;
-using uomap_ix_ctr = std::unordered_map<uint_type, uint_type>;
+/**
+ * How the edges of the board meet:
+ *
+ *  BOUNDED     cells past the edges do not exist
+ *  TORUS       left meets right and top meets bottom
+ *  KLEIN       left meets right, top meets bottom mirrored left to right
+ *
+ */
+
+enum gol_topology {BOUNDED, TORUS, KLEIN};
 
 #endif
\ No newline at end of file
@@ -26,12 +26,19 @@
 #define GOL_CREATURES_HPP
 
 #include <array>
+#include <vector>
 #include "gol_common.hpp"
+#include "index_bin.hpp"
 
 /**
  * Creature Manager for 
  * Game of Life
  * 
+ * Creatures are kept in dense arrays sized to the board: the count of
+ * every cell, and per count an index_bin of the cells in that group.
+ * Moving a creature between groups is an unuse and a use, and killing a
+ * group is O(1). All storage is sized up front and updates never allocate.
+ * 
  */
 
 template<typename uint_type>
@@ -43,13 +50,22 @@ class gol_creatures {
  */
 private:
 
+    static constexpr uint8_t none_ = 0xff;
+
     uint_type w_, h_, size_;
-    uomap_ix_ctr creature_count_;
-    std::array<uoset_ix, 9> grouped_creatures_;
+    uint_type n_{0};
+    std::vector<uint8_t> count_;
+    std::array<g80::index_bin<uint_type>, 9> grouped_creatures_;
 
 public:
 
-    gol_creatures(const uint_type w, const uint_type h) : w_(w), h_(h), size_(w * h) {}
+    gol_creatures(const uint_type w, const uint_type h) :
+        w_(w), h_(h), size_(w * h),
+        count_(size_, none_),
+        grouped_creatures_{
+            size_, size_, size_,
+            size_, size_, size_,
+            size_, size_, size_} {}
 
 /**
  * Public Interfaces
@@ -58,39 +74,48 @@ public:
 
 public:
 
-    auto exists(const uint_type ix) const -> bool {
-        auto f = creature_count_.find(ix);
-        return f != creature_count_.end();
+    inline auto exists(const uint_type ix) const -> bool {
+        return count_[ix] != none_;
     }
 
     inline auto size() const -> uint_type {
-        return static_cast<uint_type>(creature_count_.size());
+        return n_;
+    }
+
+    inline auto count(const uint_type ix) const -> uint_type {
+        return count_[ix];
     }
 
     auto update(const uint_type ix, const uint_type count) -> void {
-        auto f = creature_count_.find(ix);
-        if (f == creature_count_.end()) {
-            creature_count_.insert({ix, count});
-        } else {
-            auto pcount = f->second;
-            grouped_creatures_[pcount].erase(ix);
-            f->second = count;
-        }
-        grouped_creatures_[count].insert(ix);
+        if (count_[ix] == none_) ++n_;
+        else grouped_creatures_[count_[ix]].unuse(ix);
+
+        count_[ix] = static_cast<uint8_t>(count);
+        grouped_creatures_[count].use(ix);
     }
 
     auto kill_group(const uint_type group) {
-        for (auto ix : grouped_creatures_[group]) creature_count_.erase(ix);
-        grouped_creatures_[group].clear();
+        auto &g = grouped_creatures_[group];
+        for (auto ix : g.used()) count_[ix] = none_;
+        n_ -= g.size_of_used();
+        g.unuse_all();
+    }
+
+    auto clear() -> void {
+        for (uint_type group = 0; group <= 8; ++group) kill_group(group);
     }
 
-    inline auto get_creature_count() const -> const uomap_ix_ctr & {
-        return creature_count_;
+    inline auto get_grouped_creatures(const uint_type group) const -> typename g80::index_bin<uint_type>::range {
+        return grouped_creatures_[group].used();
     }
 
-    inline auto get_grouped_creatures(const uint_type group) const -> const uoset_ix & {
-        return grouped_creatures_[group];
+    // Calls each_creature(ix, count) for every creature
+
+    template<typename each_creature_type>
+    auto for_each(const each_creature_type &each_creature) const -> void {
+        for (uint_type group = 0; group <= 8; ++group)
+            for (auto ix : grouped_creatures_[group].used()) each_creature(ix, group);
     }
 };
 
-#endif
\ No newline at end of file
+#endif
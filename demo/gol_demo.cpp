@@ -22,12 +22,59 @@
  * 
  */
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 #include "gol.hpp"
+#include "../include/text_clip.hpp"
+#include "../include/text_frame_capture.hpp"
+
+// gol_demo --headless frames [seed [file]] runs without the terminal,
+// as fast as it goes, optionally saving every frame to file. Unlike
+// the interactive run, which seeds from the time, seed defaults to
+// HEADLESS_SEED so that two headless runs give the same frames
+// gol_demo --record file runs as usual, recording a clip to file
+// gol_demo --play file plays a recorded clip back as fast as it goes
+
+constexpr unsigned int HEADLESS_SEED = 0;
 
 auto main(const int argc, const char *argv[]) -> int {
+    if (argc >= 3 && std::string(argv[1]) == "--headless") {
+        std::size_t frames = std::strtoull(argv[2], nullptr, 10);
+        gol game_of_life(argc >= 4 ? static_cast<unsigned int>(std::strtoul(argv[3], nullptr, 10)) : HEADLESS_SEED);
+        game_of_life.preprocess();
+
+        auto start = std::chrono::steady_clock::now();
+        if (argc >= 5) {
+            text_frame_file<int_type, uint_type> file(argv[4]);
+            game_of_life.run_headless(frames, file);
+        } else {
+            game_of_life.run_headless(frames);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << frames << " frames in " << ms << " ms (" << frames * 1000.0 / ms << " frames/s)\n";
+        return 0;
+    }
+
+    if (argc >= 3 && std::string(argv[1]) == "--play") {
+        text_clip_player<int_type, uint_type> clip(argv[2]);
+        gol game_of_life;
+
+        auto start = std::chrono::steady_clock::now();
+        std::size_t frames = game_of_life.play(clip);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << frames << " frames in " << ms << " ms (" << frames * 1000.0 / ms << " frames/s)\n";
+        return 0;
+    }
+
     gol game_of_life; 
     game_of_life.preprocess();
+    if (argc >= 3 && std::string(argv[1]) == "--record") {
+        text_clip_recorder<int_type, uint_type> clip(argv[2]);
+        game_of_life.set_capture([&clip](const std::size_t frame, const text_image<int_type, uint_type> &screen) {clip(frame, screen);});
+        game_of_life.run();
+        return 0;
+    }
     game_of_life.run();
 }
-
@@ -0,0 +1,199 @@
+/**
+ * @file gol_hash.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Game of Life engine that tracks live creatures in hash sets grouped by neighbor count
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GOL_HASH_HPP
+#define GOL_HASH_HPP
+
+#include <vector>
+#include "gol_common.hpp"
+#include "gol_bounds.hpp"
+#include "gol_creatures.hpp"
+
+/**
+ * Only the creatures and the spaces
+ * around them are visited per generation
+ *
+ * The work lists of a generation are members sized to the board and
+ * reused, and cells already queued for a recount are tracked with a
+ * flag per cell that is reset as the queue is drained. Once constructed
+ * a generation does not allocate.
+ *
+ */
+
+template<uint_type w, uint_type h, gol_topology topology = BOUNDED>
+class gol_hash {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+private:
+
+    using bounds = gol_bounds<int_type, uint_type, w, h, topology>;
+
+    gol_creatures<uint_type> live_creatures_;
+    gol_creatures<uint_type> potential_creatures_;
+
+    // Scratch of a generation
+    std::vector<uint_type> to_get_neighbors_;
+    std::vector<uint_type> to_update_count_;
+    std::vector<uint_type> to_spawn_;
+    std::vector<uint8_t> is_queued_;
+
+public:
+
+    // The dimensions are fixed by the template, the
+    // arguments only mirror the other engines
+
+    gol_hash(const uint_type, const uint_type) :
+        live_creatures_(w, h),
+        potential_creatures_(w, h),
+        is_queued_(bounds::size, 0) {
+
+        to_get_neighbors_.reserve(bounds::size);
+        to_update_count_.reserve(bounds::size);
+        to_spawn_.reserve(bounds::size);
+    }
+
+    ~gol_hash() = default;
+
+/**
+ * Public Interfaces
+ *
+ */
+
+public:
+
+    inline auto size() const -> uint_type {
+        return live_creatures_.size();
+    }
+
+    template<typename ix_container_type>
+    auto reset(const ix_container_type &live) -> void {
+        live_creatures_.clear();
+        potential_creatures_.clear();
+
+        for (auto ix : live)
+            if (!bounds::is_out_of_bounds(ix)) live_creatures_.update(ix, 0);
+
+        live_creatures_.for_each([&](const uint_type ix, const uint_type) {
+            queue_update_count(ix);
+            bounds::for_each_neighbor(ix, [&](const uint_type i) {queue_update_count(i);});
+        });
+
+        update_counts();
+    }
+
+    auto step() -> void {
+        update_execute_rules();
+    }
+
+    // Calls each_creature(ix, count) for every
+    // live creature and its neighbor count
+
+    template<typename each_creature_type>
+    auto for_each_creature(const each_creature_type &each_creature) const -> void {
+        live_creatures_.for_each(each_creature);
+    }
+
+private:
+
+    inline auto queue_update_count(const uint_type ix) -> void {
+        if (is_queued_[ix]) return;
+        is_queued_[ix] = 1;
+        to_update_count_.push_back(ix);
+    }
+
+    auto update_execute_rules_get_vars() -> void {
+
+        to_get_neighbors_.clear();
+        to_spawn_.clear();
+
+        for (uint_type group{0}; group <= 8; ++group) {
+
+            // Spaces with 3 neighbors
+            // will be spawned
+            if (group == 3) {
+                for (auto ix : potential_creatures_.get_grouped_creatures(group)) {
+                    to_spawn_.push_back(ix);
+                    to_get_neighbors_.push_back(ix);
+                }
+                potential_creatures_.kill_group(group);
+
+            // Creatures with 2 neighbors will remain
+            // but the count needs to get updated
+            } else if (group == 2) {
+                for (auto ix : live_creatures_.get_grouped_creatures(group))
+                    queue_update_count(ix);
+
+
+            // Under population (0, 1) and
+            // over population (4, 5, 6, 7, 8) will be killed
+            } else {
+                for (auto ix : live_creatures_.get_grouped_creatures(group))
+                    to_get_neighbors_.push_back(ix);
+
+                live_creatures_.kill_group(group);
+            }
+        }
+    }
+
+    auto update_execute_rules() -> void {
+
+        update_execute_rules_get_vars();
+
+        // Recalc neighbors
+        auto is_live = [&](const uint_type ix) -> bool {return live_creatures_.exists(ix);};
+
+        for (auto s : to_spawn_)
+            live_creatures_.update(s, bounds::count(s, is_live));
+
+        for (auto n : to_get_neighbors_)
+            bounds::for_each_neighbor(n, [&](const uint_type ix) {queue_update_count(ix);});
+
+        update_counts();
+    }
+
+    // Recounts every queued cell and empties the queue
+
+    auto update_counts() -> void {
+        auto is_live = [&](const uint_type ix) -> bool {return live_creatures_.exists(ix);};
+
+        for (auto ix : to_update_count_) {
+            is_queued_[ix] = 0;
+            uint_type count = bounds::count(ix, is_live);
+
+            if (live_creatures_.exists(ix)) {
+                live_creatures_.update(ix, count);
+            } else if (count == 3) {
+                potential_creatures_.update(ix, count);
+            }
+        }
+
+        to_update_count_.clear();
+    }
+};
+
+#endif
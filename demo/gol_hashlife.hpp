@@ -0,0 +1,535 @@
+/**
+ * @file gol_hashlife.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Game of Life engine that jumps 2^k generations at a time over a hash-consed quadtree (HashLife)
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * The universe is a quadtree whose root at level L covers the cells from
+ * -2^(L-1) to 2^(L-1) - 1 on both axes. Nodes are hash-consed: a node with
+ * the same four children is created once, so repeated regions in space and
+ * in time share one node. Level 0 nodes are the dead and the live cell.
+ *
+ * Each node of level k >= 2 memoizes its RESULT: the center node of level
+ * k - 1, advanced 2^min(k - 2, step_log) generations. One step() advances
+ * the whole universe 2^step_log generations. Changing step_log clears the
+ * memos since they were computed for the previous step size.
+ *
+ * Nodes live in one vector and are referred to by index. The memory cap is
+ * checked as each node is created. A step that goes over it unwinds without
+ * finishing, the nodes that can no longer be reached from the root are
+ * dropped, and the step is done again as two steps of half the size, down
+ * to single generations. Dropping keeps the RESULT memos when they fit in
+ * half the cap, else it evicts them and keeps only the pattern itself.
+ *
+ * The cap is still soft: it can be passed by the nodes of one recursion
+ * path before a step unwinds, by set() and by growing the universe, and by
+ * a step whose pattern alone takes more than half the cap, which then runs
+ * past it rather than be split without end.
+ *
+ */
+
+#ifndef GOL_HASHLIFE_HPP
+#define GOL_HASHLIFE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../include/text_image.hpp"
+
+class gol_hashlife {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+public:
+
+    using node_id = uint32_t;
+    static constexpr node_id none = ~node_id{0};
+    static constexpr node_id dead = 0;
+    static constexpr node_id alive = 1;
+
+private:
+
+    struct node {
+        node_id nw, ne, sw, se;
+        node_id result;
+        uint32_t level;
+        uint64_t population;
+    };
+
+    // Nodes per byte of the memory cap: the node
+    // itself plus two hash table slots
+
+    static constexpr std::size_t size_of_node = sizeof(node) + 2 * sizeof(node_id);
+
+    std::vector<node> nodes_;
+    std::vector<node_id> table_;
+    std::vector<node_id> empty_;
+    node_id root_{none};
+    uint32_t step_log_{0};
+    uint64_t generation_{0};
+    std::size_t max_nodes_;
+    std::size_t collections_{0};
+    bool is_capped_{false};
+    bool is_over_cap_{false};
+
+public:
+
+    gol_hashlife(const std::size_t memory_cap = std::size_t{256} << 20) :
+        max_nodes_(memory_cap / size_of_node) {
+        clear();
+    }
+
+    gol_hashlife(const gol_hashlife &) = delete;
+    auto operator=(const gol_hashlife &) -> gol_hashlife & = delete;
+    ~gol_hashlife() = default;
+
+/**
+ * Getters
+ *
+ */
+
+public:
+
+    inline auto generation() const -> uint64_t {
+        return generation_;
+    }
+
+    inline auto population() const -> uint64_t {
+        return nodes_[root_].population;
+    }
+
+    inline auto step_log() const -> uint32_t {
+        return step_log_;
+    }
+
+    inline auto nodes() const -> std::size_t {
+        return nodes_.size();
+    }
+
+    inline auto collections() const -> std::size_t {
+        return collections_;
+    }
+
+    inline auto level() const -> uint32_t {
+        return nodes_[root_].level;
+    }
+
+/**
+ * Cells
+ *
+ */
+
+public:
+
+    auto clear() -> void {
+        nodes_.clear();
+        nodes_.push_back({none, none, none, none, none, 0, 0});
+        nodes_.push_back({none, none, none, none, none, 0, 1});
+        table_.assign(1024, none);
+        empty_.clear();
+        root_ = empty(3);
+        generation_ = 0;
+    }
+
+    auto set(const int64_t x, const int64_t y, const bool is_alive) -> void {
+        while (!is_inside(x, y)) expand();
+        int64_t half = int64_t{1} << (level() - 1);
+        root_ = set(root_, x + half, y + half, is_alive);
+    }
+
+    auto get(const int64_t x, const int64_t y) const -> bool {
+        if (!is_inside(x, y)) return false;
+        int64_t half = int64_t{1} << (level() - 1);
+        node_id n = root_;
+        uint64_t cx = static_cast<uint64_t>(x + half), cy = static_cast<uint64_t>(y + half);
+        while (nodes_[n].level > 0 && nodes_[n].population > 0) {
+            uint32_t shift = nodes_[n].level - 1;
+            bool is_east = (cx >> shift) & 1, is_south = (cy >> shift) & 1;
+            const node &p = nodes_[n];
+            n = is_south ? (is_east ? p.se : p.sw) : (is_east ? p.ne : p.nw);
+        }
+        return n == alive;
+    }
+
+/**
+ * Stepping
+ *
+ */
+
+public:
+
+    auto set_step_log(const uint32_t step_log) -> void {
+        if (step_log == step_log_) return;
+        step_log_ = step_log;
+        for (auto &n : nodes_) n.result = none;
+    }
+
+    // Advances 2^step_log generations
+
+    auto step() -> void {
+        uint32_t level_before = level();
+        while (level() < step_log_ + 3 || !is_padded(root_)) expand();
+        expand();
+
+        is_capped_ = true;
+        is_over_cap_ = false;
+        node_id r = result(root_);
+        is_capped_ = false;
+
+        // Over the cap: the halves expand the root
+        // again, so undo the expansions of this step
+        if (r == none) {
+            collect();
+            if (step_log_ > 0 && nodes_.size() * 2 <= max_nodes_) {
+                while (level() > level_before) root_ = center(root_);
+                uint32_t step_log = step_log_;
+                set_step_log(step_log - 1);
+                step();
+                step();
+                set_step_log(step_log);
+                return;
+            }
+            is_over_cap_ = false;
+            r = result(root_);
+        }
+
+        root_ = r;
+        generation_ += uint64_t{1} << step_log_;
+        if (nodes_.size() > max_nodes_) collect();
+    }
+
+    // Advances any number of generations as a sum of
+    // powers of 2, leaving step_log at the last one used
+
+    auto advance(uint64_t generations) -> void {
+        for (uint32_t k = 0; generations; ++k, generations >>= 1) {
+            if (!(generations & 1)) continue;
+            set_step_log(k);
+            step();
+        }
+    }
+
+/**
+ * Rasterizer
+ *
+ */
+
+public:
+
+    // Draws the cells from (vx, vy) onwards into timg. With a zoom_log
+    // above 0, one text cell stands for a 2^zoom_log square of cells
+    // and is alive if any of them is.
+
+    template<typename int_type, typename uint_type>
+    auto rasterize(
+        g80::text_image<int_type, uint_type> &timg, const int64_t vx, const int64_t vy, const uint32_t zoom_log = 0,
+        const g80::text alive_text = '*', const g80::color alive_color = 7) const -> void {
+
+        timg.fill_text(' ');
+        int64_t half = int64_t{1} << (level() - 1);
+        rasterize(timg, root_, -half, -half, vx, vy, zoom_log, alive_text, alive_color);
+    }
+
+private:
+
+    template<typename int_type, typename uint_type>
+    auto rasterize(
+        g80::text_image<int_type, uint_type> &timg, const node_id n, const int64_t x, const int64_t y,
+        const int64_t vx, const int64_t vy, const uint32_t zoom_log,
+        const g80::text alive_text, const g80::color alive_color) const -> void {
+
+        const node &p = nodes_[n];
+        if (p.population == 0) return;
+
+        int64_t size = int64_t{1} << p.level;
+        int64_t ex = vx + (static_cast<int64_t>(timg.width()) << zoom_log);
+        int64_t ey = vy + (static_cast<int64_t>(timg.height()) << zoom_log);
+        if (x + size <= vx || y + size <= vy || x >= ex || y >= ey) return;
+
+        if (p.level <= zoom_log) {
+            int_type sx = static_cast<int_type>((std::max(x, vx) - vx) >> zoom_log);
+            int_type sy = static_cast<int_type>((std::max(y, vy) - vy) >> zoom_log);
+            timg.set_text(sx, sy, alive_text);
+            timg.set_color(sx, sy, alive_color);
+            return;
+        }
+
+        int64_t half = size >> 1;
+        rasterize(timg, p.nw, x, y, vx, vy, zoom_log, alive_text, alive_color);
+        rasterize(timg, p.ne, x + half, y, vx, vy, zoom_log, alive_text, alive_color);
+        rasterize(timg, p.sw, x, y + half, vx, vy, zoom_log, alive_text, alive_color);
+        rasterize(timg, p.se, x + half, y + half, vx, vy, zoom_log, alive_text, alive_color);
+    }
+
+/**
+ * Quadtree
+ *
+ */
+
+private:
+
+    static inline auto hash(const node_id nw, const node_id ne, const node_id sw, const node_id se) -> uint64_t {
+        uint64_t h = (static_cast<uint64_t>(nw) << 32 | ne) * 0x9e3779b97f4a7c15ull;
+        h ^= (static_cast<uint64_t>(sw) << 32 | se) * 0xc2b2ae3d27d4eb4full;
+        return h ^ (h >> 29);
+    }
+
+    // The one node with these four children
+
+    auto join(const node_id nw, const node_id ne, const node_id sw, const node_id se) -> node_id {
+        std::size_t mask = table_.size() - 1;
+        std::size_t i = hash(nw, ne, sw, se) & mask;
+        for (; table_[i] != none; i = (i + 1) & mask) {
+            const node &p = nodes_[table_[i]];
+            if (p.nw == nw && p.ne == ne && p.sw == sw && p.se == se) return table_[i];
+        }
+
+        node_id n = static_cast<node_id>(nodes_.size());
+        nodes_.push_back({nw, ne, sw, se, none, nodes_[nw].level + 1,
+            nodes_[nw].population + nodes_[ne].population + nodes_[sw].population + nodes_[se].population});
+        table_[i] = n;
+        if (nodes_.size() * 2 > table_.size()) rehash(table_.size() * 2);
+        if (nodes_.size() > max_nodes_ && is_capped_) is_over_cap_ = true;
+        return n;
+    }
+
+    auto rehash(const std::size_t size) -> void {
+        table_.assign(size, none);
+        std::size_t mask = size - 1;
+        for (node_id n = alive + 1; n < nodes_.size(); ++n) {
+            const node &p = nodes_[n];
+            std::size_t i = hash(p.nw, p.ne, p.sw, p.se) & mask;
+            while (table_[i] != none) i = (i + 1) & mask;
+            table_[i] = n;
+        }
+    }
+
+    auto empty(const uint32_t level) -> node_id {
+        if (empty_.empty()) empty_.push_back(dead);
+        while (empty_.size() <= level) {
+            node_id e = empty_.back();
+            empty_.push_back(join(e, e, e, e));
+        }
+        return empty_[level];
+    }
+
+    auto is_inside(const int64_t x, const int64_t y) const -> bool {
+        int64_t half = int64_t{1} << (level() - 1);
+        return x >= -half && x < half && y >= -half && y < half;
+    }
+
+    // Surrounds the root with empty space, one level up
+
+    auto expand() -> void {
+        node r = nodes_[root_];
+        node_id e = empty(r.level - 1);
+        node_id nw = join(e, e, e, r.nw);
+        node_id ne = join(e, e, r.ne, e);
+        node_id sw = join(e, r.sw, e, e);
+        node_id se = join(r.se, e, e, e);
+        root_ = join(nw, ne, sw, se);
+    }
+
+    // True if all the cells are in the inner half
+
+    auto is_padded(const node_id n) const -> bool {
+        const node &p = nodes_[n];
+        return nodes_[p.nw].population == nodes_[nodes_[p.nw].se].population &&
+               nodes_[p.ne].population == nodes_[nodes_[p.ne].sw].population &&
+               nodes_[p.sw].population == nodes_[nodes_[p.sw].ne].population &&
+               nodes_[p.se].population == nodes_[nodes_[p.se].nw].population;
+    }
+
+    auto set(const node_id n, const int64_t x, const int64_t y, const bool is_alive) -> node_id {
+        node p = nodes_[n];
+        if (p.level == 0) return is_alive ? alive : dead;
+        int64_t half = int64_t{1} << (p.level - 1);
+        if (y < half) {
+            if (x < half) return join(set(p.nw, x, y, is_alive), p.ne, p.sw, p.se);
+            return join(p.nw, set(p.ne, x - half, y, is_alive), p.sw, p.se);
+        }
+        if (x < half) return join(p.nw, p.ne, set(p.sw, x, y - half, is_alive), p.se);
+        return join(p.nw, p.ne, p.sw, set(p.se, x - half, y - half, is_alive));
+    }
+
+/**
+ * RESULT
+ *
+ */
+
+private:
+
+    // Level 2 base case: the 2x2 center of a
+    // 4x4 node, one generation later
+
+    auto result_of_level2(const node &p) -> node_id {
+        uint32_t cells = 0;
+        const node_id quads[4] = {p.nw, p.ne, p.sw, p.se};
+        for (uint32_t q = 0; q < 4; ++q) {
+            const node &c = nodes_[quads[q]];
+            uint32_t qx = (q & 1) * 2, qy = (q >> 1) * 2;
+            cells |= (c.nw == alive) << ((qy + 0) * 4 + qx + 0);
+            cells |= (c.ne == alive) << ((qy + 0) * 4 + qx + 1);
+            cells |= (c.sw == alive) << ((qy + 1) * 4 + qx + 0);
+            cells |= (c.se == alive) << ((qy + 1) * 4 + qx + 1);
+        }
+
+        node_id next[4];
+        for (uint32_t i = 0; i < 4; ++i) {
+            uint32_t x = 1 + (i & 1), y = 1 + (i >> 1);
+            uint32_t count = 0;
+            for (uint32_t ny = y - 1; ny <= y + 1; ++ny)
+                for (uint32_t nx = x - 1; nx <= x + 1; ++nx)
+                    if (nx != x || ny != y) count += (cells >> (ny * 4 + nx)) & 1;
+            bool is_alive = (cells >> (y * 4 + x)) & 1;
+            next[i] = (count == 3 || (is_alive && count == 2)) ? alive : dead;
+        }
+        return join(next[0], next[1], next[2], next[3]);
+    }
+
+    // The level k - 2 center of a level k - 1 node, not advanced
+
+    auto center(const node_id n) -> node_id {
+        node p = nodes_[n];
+        return join(nodes_[p.nw].se, nodes_[p.ne].sw, nodes_[p.sw].ne, nodes_[p.se].nw);
+    }
+
+    // none once the step is over the cap, without
+    // memoizing anything that was left unfinished
+
+    auto result(const node_id n) -> node_id {
+        if (nodes_[n].result != none) return nodes_[n].result;
+        if (is_over_cap_) return none;
+
+        node p = nodes_[n];
+        node_id r;
+        if (p.population == 0) {
+            r = empty(p.level - 1);
+        } else if (p.level == 2) {
+            r = result_of_level2(p);
+        } else {
+            node nw = nodes_[p.nw], ne = nodes_[p.ne], sw = nodes_[p.sw], se = nodes_[p.se];
+
+            // The 9 overlapping level k - 1 nodes of a 3x3 grid
+            node_id n00 = p.nw;
+            node_id n01 = join(nw.ne, ne.nw, nw.se, ne.sw);
+            node_id n02 = p.ne;
+            node_id n10 = join(nw.sw, nw.se, sw.nw, sw.ne);
+            node_id n11 = join(nw.se, ne.sw, sw.ne, se.nw);
+            node_id n12 = join(ne.sw, ne.se, se.nw, se.ne);
+            node_id n20 = p.sw;
+            node_id n21 = join(sw.ne, se.nw, sw.se, se.sw);
+            node_id n22 = p.se;
+
+            // At full speed both halves advance, otherwise
+            // only the second half does
+            bool is_full_speed = step_log_ >= p.level - 2;
+            auto half_step = [&](const node_id m) -> node_id {return is_full_speed ? result(m) : center(m);};
+
+            node_id r00 = half_step(n00), r01 = half_step(n01), r02 = half_step(n02);
+            node_id r10 = half_step(n10), r11 = half_step(n11), r12 = half_step(n12);
+            node_id r20 = half_step(n20), r21 = half_step(n21), r22 = half_step(n22);
+            if (is_over_cap_) return none;
+
+            node_id q_nw = result(join(r00, r01, r10, r11));
+            node_id q_ne = result(join(r01, r02, r11, r12));
+            node_id q_sw = result(join(r10, r11, r20, r21));
+            node_id q_se = result(join(r11, r12, r21, r22));
+            if (is_over_cap_) return none;
+            r = join(q_nw, q_ne, q_sw, q_se);
+        }
+
+        nodes_[n].result = r;
+        return r;
+    }
+
+/**
+ * Memory cap
+ *
+ */
+
+private:
+
+    auto mark(std::vector<uint8_t> &is_kept, const bool is_keeping_results) const -> std::size_t {
+        std::size_t kept = 0;
+        std::vector<node_id> stack{dead, alive, root_};
+        while (!stack.empty()) {
+            node_id n = stack.back();
+            stack.pop_back();
+            if (n == none || is_kept[n]) continue;
+            is_kept[n] = 1;
+            ++kept;
+            const node &p = nodes_[n];
+            if (p.level == 0) continue;
+            stack.push_back(p.nw);
+            stack.push_back(p.ne);
+            stack.push_back(p.sw);
+            stack.push_back(p.se);
+            if (is_keeping_results) stack.push_back(p.result);
+        }
+        return kept;
+    }
+
+    auto collect() -> void {
+        ++collections_;
+
+        // Keep the memos of the live nodes if they fit
+        // in half the cap, else evict every memo
+        std::vector<uint8_t> is_kept(nodes_.size(), 0);
+        bool is_keeping_results = true;
+        if (mark(is_kept, true) > max_nodes_ / 2) {
+            is_keeping_results = false;
+            std::fill(is_kept.begin(), is_kept.end(), 0);
+            mark(is_kept, false);
+        }
+
+        // Children are always created before their
+        // parents, so ids only ever move down
+        std::vector<node_id> remap(nodes_.size(), none);
+        node_id kept = 0;
+        for (node_id n = 0; n < nodes_.size(); ++n) {
+            if (!is_kept[n]) continue;
+            remap[n] = kept;
+            nodes_[kept++] = nodes_[n];
+        }
+        nodes_.resize(kept);
+
+        for (auto &p : nodes_) {
+            if (p.level == 0) continue;
+            p.nw = remap[p.nw];
+            p.ne = remap[p.ne];
+            p.sw = remap[p.sw];
+            p.se = remap[p.se];
+            p.result = is_keeping_results && p.result != none ? remap[p.result] : none;
+        }
+        root_ = remap[root_];
+        empty_.clear();
+
+        std::size_t size = 1024;
+        while (size < nodes_.size() * 2) size *= 2;
+        rehash(size);
+    }
+};
+
+#endif
@@ -0,0 +1,413 @@
+/**
+ * @file gol_rule.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Cellular automaton rules compiled from rulestrings or template parameters
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Rulestrings accepted by gol_rule:
+ *
+ *  B3/S23              Life-like, birth and survival counts
+ *  23/3                the same as survival/birth
+ *  B2/S/C3             Generations: a cell that stops surviving decays
+ *  /2/3                through C - 2 dying states (Brian's Brain)
+ *  R5,C0,M1,S34..58,B34..45,NM
+ *                      Larger than Life: Moore radius R, C states, M1 if
+ *                      the cell counts itself, S and B as count ranges
+ *
+ * A gol_rule is compiled into a lookup table of the next state for every
+ * state and neighbor count, used by gol_rule_board.
+ *
+ * Life-like rules of radius 1 also run on the 64-cell words of gol_bitboard.
+ * There a rule is a function of the cell word and the 4 bit planes of its
+ * neighbor count. gol_rule_bs takes the rule as template parameters, so the
+ * compiler folds the table into the same few boolean operations a kernel
+ * written by hand for that rule would have. gol_rule_bitsliced takes a
+ * gol_rule at run time and ORs one term per count in the rule.
+ *
+ */
+
+#ifndef GOL_RULE_HPP
+#define GOL_RULE_HPP
+
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Neighbor count of 64 cells
+ * as bit planes
+ *
+ */
+
+struct gol_count_planes {
+    uint64_t p1, p2, p4, p8;
+
+    inline auto count(const uint_fast8_t bit) const -> uint_fast8_t {
+        return static_cast<uint_fast8_t>(
+            ((p1 >> bit) & 1) | (((p2 >> bit) & 1) << 1) | (((p4 >> bit) & 1) << 2) | (((p8 >> bit) & 1) << 3));
+    }
+};
+
+/**
+ * Rulestring parser and
+ * next state table
+ *
+ */
+
+class gol_rule {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+private:
+
+    uint32_t radius_{1};
+    uint32_t states_{2};
+    bool is_center_counted_{false};
+    std::vector<uint8_t> birth_, survive_;
+    std::vector<uint8_t> next_;
+    uint32_t size_of_counts_{0};
+
+public:
+
+    gol_rule(const std::string &rulestring = "B3/S23") {
+        std::string r;
+        for (char c : rulestring) if (!std::isspace(static_cast<unsigned char>(c))) r += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+        if (!r.empty() && r[0] == 'R') parse_larger_than_life(r);
+        else parse_life_like(r);
+
+        compile();
+    }
+
+/**
+ * Getters
+ *
+ */
+
+public:
+
+    inline auto radius() const -> uint32_t {
+        return radius_;
+    }
+
+    inline auto states() const -> uint32_t {
+        return states_;
+    }
+
+    inline auto is_center_counted() const -> bool {
+        return is_center_counted_;
+    }
+
+    // Largest possible count of live cells around a cell
+
+    inline auto max_count() const -> uint32_t {
+        return (2 * radius_ + 1) * (2 * radius_ + 1) - (is_center_counted_ ? 0 : 1);
+    }
+
+    inline auto is_birth(const uint32_t count) const -> bool {
+        return count < birth_.size() && birth_[count];
+    }
+
+    inline auto is_survival(const uint32_t count) const -> bool {
+        return count < survive_.size() && survive_[count];
+    }
+
+    // Rules that gol_bitboard can step
+
+    inline auto is_life_like() const -> bool {
+        return radius_ == 1 && states_ == 2 && !is_center_counted_;
+    }
+
+    // State 0 is dead, 1 is alive, 2 to states - 1 are dying
+
+    inline auto next(const uint8_t state, const uint32_t count) const -> uint8_t {
+        return next_[state * size_of_counts_ + count];
+    }
+
+private:
+
+    auto invalid() const -> void {
+        throw std::runtime_error(std::string("Invalid rulestring."));
+    }
+
+    static auto read_uint(const std::string &r, std::size_t &i) -> uint32_t {
+        uint32_t n = 0;
+        while (i < r.size() && std::isdigit(static_cast<unsigned char>(r[i]))) n = n * 10 + (r[i++] - '0');
+        return n;
+    }
+
+    auto parse_counts(const std::string &digits, std::vector<uint8_t> &counts) -> void {
+        counts.assign(9, 0);
+        for (char c : digits) {
+            if (c < '0' || c > '8') invalid();
+            counts[c - '0'] = 1;
+        }
+    }
+
+    auto parse_life_like(const std::string &r) -> void {
+        std::vector<std::string> parts{""};
+        for (char c : r) {
+            if (c == '/') parts.emplace_back();
+            else parts.back() += c;
+        }
+        if (parts.size() < 2 || parts.size() > 3) invalid();
+
+        std::string b, s, c;
+        bool is_lettered = false;
+        for (auto &p : parts) {
+            if (p.empty()) continue;
+            if (p[0] == 'B') {b = p.substr(1); is_lettered = true;}
+            else if (p[0] == 'S') {s = p.substr(1); is_lettered = true;}
+            else if (p[0] == 'C' || p[0] == 'G') {c = p.substr(1); is_lettered = true;}
+        }
+
+        // Positional form is survival/birth[/states]
+        if (!is_lettered) {
+            s = parts[0];
+            b = parts[1];
+            if (parts.size() == 3) c = parts[2];
+        }
+
+        parse_counts(b, birth_);
+        parse_counts(s, survive_);
+
+        states_ = 2;
+        if (!c.empty()) {
+            std::size_t i = 0;
+            states_ = read_uint(c, i);
+            if (i != c.size() || states_ < 2 || states_ > 256) invalid();
+        }
+    }
+
+    auto parse_larger_than_life(const std::string &r) -> void {
+        uint32_t smin = 1, smax = 0, bmin = 1, bmax = 0;
+        std::size_t i = 0;
+        while (i < r.size()) {
+            char key = r[i++];
+            if (key == 'N') {
+                if (i >= r.size() || r[i++] != 'M') invalid();
+            } else {
+                uint32_t lo = read_uint(r, i), hi = lo;
+                if ((key == 'S' || key == 'B') && r.compare(i, 2, "..") == 0) {
+                    i += 2;
+                    hi = read_uint(r, i);
+                }
+                if (key == 'R') radius_ = lo;
+                else if (key == 'C') states_ = lo < 2 ? 2 : lo;
+                else if (key == 'M') is_center_counted_ = lo == 1;
+                else if (key == 'S') {smin = lo; smax = hi;}
+                else if (key == 'B') {bmin = lo; bmax = hi;}
+                else invalid();
+            }
+            if (i < r.size() && r[i++] != ',') invalid();
+        }
+
+        if (radius_ < 1 || radius_ > 16 || states_ > 256) invalid();
+        birth_.assign(max_count() + 1, 0);
+        survive_.assign(max_count() + 1, 0);
+        for (uint32_t n = bmin; n <= bmax && n <= max_count(); ++n) birth_[n] = 1;
+        for (uint32_t n = smin; n <= smax && n <= max_count(); ++n) survive_[n] = 1;
+    }
+
+    auto compile() -> void {
+        uint32_t counts = size_of_counts_ = max_count() + 1;
+        next_.assign(states_ * counts, 0);
+        for (uint32_t n = 0; n < counts; ++n) {
+            next_[n] = is_birth(n) ? 1 : 0;
+            next_[counts + n] = is_survival(n) ? 1 : (states_ > 2 ? 2 : 0);
+            for (uint32_t state = 2; state < states_; ++state)
+                next_[state * counts + n] = state + 1 < states_ ? state + 1 : 0;
+        }
+    }
+};
+
+/**
+ * Life-like rules over 64 cells
+ * at a time for gol_bitboard
+ *
+ */
+
+// A rule over 64 cells is a boolean function of 5 inputs: the count planes
+// p1, p2, p4, p8 (inputs 0 to 3) and the cells themselves (input 4). Its
+// truth table has 32 entries, entry alive * 16 + count. Counts 9 to 15
+// never occur and are left as don't-cares.
+
+constexpr uint32_t gol_rule_care = 0x01ff01ff;
+
+constexpr auto gol_rule_table(const uint16_t birth, const uint16_t survive) -> uint32_t {
+    return (birth & 0x1ffu) | (static_cast<uint32_t>(survive & 0x1ffu) << 16);
+}
+
+// Inputs are split in this order, p8 first since
+// it is only set for a count of 8
+
+constexpr auto gol_rule_next_input(const uint32_t input) -> uint32_t {
+    return input == 0 ? 4 : input == 4 ? 5 : input - 1;
+}
+
+template<uint32_t input>
+inline auto gol_rule_input(const uint64_t alive, const gol_count_planes &c) -> uint64_t {
+    if constexpr (input == 0) return c.p1;
+    else if constexpr (input == 1) return c.p2;
+    else if constexpr (input == 2) return c.p4;
+    else if constexpr (input == 3) return c.p8;
+    else return alive;
+}
+
+// The halves of a table where an input is 0 and 1, both
+// moved onto the entries where that input is 0
+
+struct gol_rule_cofactors {
+    uint32_t ones0, care0, ones1, care1;
+};
+
+constexpr auto gol_rule_split(const uint32_t ones, const uint32_t care, const uint32_t input) -> gol_rule_cofactors {
+    uint32_t is_set = 0;
+    for (uint32_t e = 0; e < 32; ++e) if ((e >> input) & 1) is_set |= 1u << e;
+    uint32_t shift = 1u << input;
+    return {ones & care & ~is_set, care & ~is_set, (ones & care & is_set) >> shift, (care & is_set) >> shift};
+}
+
+// Shannon expansion of the table, one input at a time. An input whose
+// halves agree wherever both are cared for is dropped, and halves that
+// are constant fold into a single AND or OR. All of it is decided at
+// compile time, so only the remaining boolean operations are emitted.
+
+template<uint32_t ones, uint32_t care, uint32_t input = 3>
+struct gol_rule_formula {
+
+    static constexpr bool is_zero = (ones & care) == 0;
+    static constexpr bool is_all = (ones & care) == care;
+
+    static inline auto eval(const uint64_t alive, const gol_count_planes &c) -> uint64_t {
+        if constexpr (is_zero) {
+            return 0;
+        } else if constexpr (is_all) {
+            return ~uint64_t{0};
+        } else {
+            constexpr gol_rule_cofactors f = gol_rule_split(ones, care, input);
+            constexpr uint32_t next = gol_rule_next_input(input);
+
+            if constexpr (((f.ones0 ^ f.ones1) & f.care0 & f.care1) == 0) {
+                return gol_rule_formula<f.ones0 | f.ones1, f.care0 | f.care1, next>::eval(alive, c);
+            } else {
+                using lo = gol_rule_formula<f.ones0, f.care0, next>;
+                using hi = gol_rule_formula<f.ones1, f.care1, next>;
+                uint64_t x = gol_rule_input<input>(alive, c);
+                if constexpr (lo::is_zero) return x & hi::eval(alive, c);
+                else if constexpr (hi::is_zero) return ~x & lo::eval(alive, c);
+                else if constexpr (hi::is_all) return x | lo::eval(alive, c);
+                else if constexpr (lo::is_all) return ~x | hi::eval(alive, c);
+                else return (x & hi::eval(alive, c)) | (~x & lo::eval(alive, c));
+            }
+        }
+    }
+};
+
+template<uint16_t birth, uint16_t survive>
+struct gol_rule_bs {
+    inline auto operator()(const uint64_t alive, const gol_count_planes &c) const -> uint64_t {
+        return gol_rule_formula<gol_rule_table(birth, survive), gol_rule_care>::eval(alive, c);
+    }
+};
+
+using gol_rule_life = gol_rule_bs<(1 << 3), (1 << 2) | (1 << 3)>;
+using gol_rule_highlife = gol_rule_bs<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)>;
+using gol_rule_day_and_night = gol_rule_bs<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)>;
+using gol_rule_seeds = gol_rule_bs<(1 << 2), 0>;
+
+// The same expansion done at run time, flattened into a sum of
+// products: each term is an AND of some of the 5 inputs, each
+// input taken as is or inverted
+
+class gol_rule_bitsliced {
+
+private:
+
+    struct term {
+        uint64_t inverted[5];
+        uint64_t ignored[5];
+    };
+
+    std::vector<term> terms_;
+
+public:
+
+    gol_rule_bitsliced(const gol_rule &rule = gol_rule()) {
+        if (!rule.is_life_like()) throw std::runtime_error(std::string("Rule is not life-like."));
+        uint16_t birth = 0, survive = 0;
+        for (uint32_t n = 0; n <= 8; ++n) {
+            if (rule.is_birth(n)) birth |= 1 << n;
+            if (rule.is_survival(n)) survive |= 1 << n;
+        }
+
+        term t;
+        for (uint32_t i = 0; i < 5; ++i) {t.inverted[i] = 0; t.ignored[i] = ~uint64_t{0};}
+        expand(gol_rule_table(birth, survive), gol_rule_care, 3, t);
+    }
+
+    inline auto operator()(const uint64_t alive, const gol_count_planes &c) const -> uint64_t {
+        const uint64_t x[5] = {c.p1, c.p2, c.p4, c.p8, alive};
+        uint64_t cells = 0;
+        for (auto &t : terms_) {
+            uint64_t cube = ~uint64_t{0};
+            for (uint32_t i = 0; i < 5; ++i) cube &= (x[i] ^ t.inverted[i]) | t.ignored[i];
+            cells |= cube;
+        }
+        return cells;
+    }
+
+private:
+
+    auto expand(const uint32_t ones, const uint32_t care, const uint32_t input, term t) -> void {
+        if ((ones & care) == 0) return;
+        if ((ones & care) == care) {terms_.push_back(t); return;}
+
+        gol_rule_cofactors f = gol_rule_split(ones, care, input);
+        uint32_t next = gol_rule_next_input(input);
+        if (((f.ones0 ^ f.ones1) & f.care0 & f.care1) == 0) {
+            expand(f.ones0 | f.ones1, f.care0 | f.care1, next, t);
+            return;
+        }
+
+        bool is_lo_all = (f.ones0 & f.care0) == f.care0;
+        bool is_hi_all = (f.ones1 & f.care1) == f.care1;
+
+        // x | lo, ~x | hi, else x & hi | ~x & lo
+        term with_x = t, with_not_x = t;
+        with_x.ignored[input] = 0;
+        with_not_x.ignored[input] = 0;
+        with_not_x.inverted[input] = ~uint64_t{0};
+
+        if (is_hi_all) {terms_.push_back(with_x); expand(f.ones0, f.care0, next, t); return;}
+        if (is_lo_all) {terms_.push_back(with_not_x); expand(f.ones1, f.care1, next, t); return;}
+        expand(f.ones1, f.care1, next, with_x);
+        expand(f.ones0, f.care0, next, with_not_x);
+    }
+};
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file gol_rule_board.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Cellular automaton engine for any gol_rule, including Generations and Larger than Life
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * One byte per cell holds its state. The live neighbors of every cell are
+ * counted once per generation with sliding windows: a running sum down each
+ * column over 2R + 1 rows, then a running sum of those along the row over
+ * 2R + 1 columns, so the cost does not grow with the radius. The next state
+ * is then a lookup in the table compiled by gol_rule. Cells past the edges
+ * are dead.
+ *
+ */
+
+#ifndef GOL_RULE_BOARD_HPP
+#define GOL_RULE_BOARD_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "gol_rule.hpp"
+
+template<typename uint_type>
+class gol_rule_board {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+private:
+
+    uint_type w_, h_;
+    gol_rule rule_;
+    std::vector<uint8_t> curr_, next_;
+    std::vector<uint16_t> counts_;
+    std::vector<uint16_t> column_;
+
+public:
+
+    gol_rule_board(const uint_type w, const uint_type h, const gol_rule &rule = gol_rule()) :
+        w_(w), h_(h),
+        rule_(rule),
+        curr_(static_cast<std::size_t>(w) * h, 0),
+        next_(static_cast<std::size_t>(w) * h, 0),
+        counts_(static_cast<std::size_t>(w) * h, 0),
+        column_(w, 0) {}
+
+    ~gol_rule_board() = default;
+
+/**
+ * Public Interfaces
+ *
+ */
+
+public:
+
+    inline auto width() const -> uint_type {
+        return w_;
+    }
+
+    inline auto height() const -> uint_type {
+        return h_;
+    }
+
+    inline auto rule() const -> const gol_rule & {
+        return rule_;
+    }
+
+    inline auto state(const uint_type x, const uint_type y) const -> uint8_t {
+        return curr_[static_cast<std::size_t>(y) * w_ + x];
+    }
+
+    auto size() const -> std::size_t {
+        return static_cast<std::size_t>(std::count(curr_.begin(), curr_.end(), 1));
+    }
+
+    template<typename ix_container_type>
+    auto reset(const ix_container_type &live) -> void {
+        std::fill(curr_.begin(), curr_.end(), 0);
+        for (auto ix : live)
+            if (ix < curr_.size()) curr_[ix] = 1;
+        count();
+    }
+
+    auto step() -> void {
+        for (std::size_t i = 0; i < curr_.size(); ++i)
+            next_[i] = rule_.next(curr_[i], counts_[i]);
+        curr_.swap(next_);
+        count();
+    }
+
+    // Calls each_creature(ix, count) for every
+    // live creature and its neighbor count
+
+    template<typename each_creature_type>
+    auto for_each_creature(const each_creature_type &each_creature) const -> void {
+        for (std::size_t i = 0; i < curr_.size(); ++i)
+            if (curr_[i] == 1) each_creature(static_cast<uint_type>(i), counts_[i]);
+    }
+
+private:
+
+    inline auto is_alive(const std::size_t x, const std::size_t y) const -> uint16_t {
+        return curr_[y * w_ + x] == 1;
+    }
+
+    auto count() -> void {
+        const int64_t r = rule_.radius();
+        const int64_t w = w_, h = h_;
+        const bool is_center_counted = rule_.is_center_counted();
+
+        // Column sums of rows -r..r
+        std::fill(column_.begin(), column_.end(), 0);
+        for (int64_t y = 0; y <= r && y < h; ++y)
+            for (int64_t x = 0; x < w; ++x) column_[x] += is_alive(x, y);
+
+        for (int64_t y = 0; y < h; ++y) {
+            uint32_t sum = 0;
+            for (int64_t x = 0; x <= r && x < w; ++x) sum += column_[x];
+
+            uint16_t *counts = &counts_[y * w];
+            for (int64_t x = 0; x < w; ++x) {
+                counts[x] = static_cast<uint16_t>(sum - (is_center_counted ? 0 : is_alive(x, y)));
+                if (x + r + 1 < w) sum += column_[x + r + 1];
+                if (x - r >= 0) sum -= column_[x - r];
+            }
+
+            // Slide the column sums one row down
+            if (y + r + 1 < h) for (int64_t x = 0; x < w; ++x) column_[x] += is_alive(x, y + r + 1);
+            if (y - r >= 0) for (int64_t x = 0; x < w; ++x) column_[x] -= is_alive(x, y - r);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file gol_scaling_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Generations per second of gol_bitboard for 1 to N threads
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "gol_bitboard.hpp"
+
+/**
+ * gol_scaling_bench [threads [size [seconds]]]
+ *
+ * Steps a size x size gol_bitboard (4096 by default) with 1 up to
+ * threads threads (the hardware threads by default), each for at
+ * least seconds (1 by default), and prints the generations per
+ * second and the speedup over 1 thread.
+ *
+ * The board is seeded with a third of its cells alive and seeded
+ * again every 100 generations, outside of the time taken, so that
+ * every tile is still active
+ *
+ */
+
+constexpr uint64_t GENERATIONS_PER_SEED = 100;
+
+auto random_board(const uint64_t size) -> std::vector<uint32_t> {
+    std::mt19937 rng(7);
+    std::vector<uint32_t> live;
+    live.reserve(size / 3 + 1);
+    for (uint64_t i = 0; i < size; ++i) if (rng() % 3 == 0) live.push_back(static_cast<uint32_t>(i));
+    return live;
+}
+
+auto generations_per_second(gol_bitboard<uint32_t> &engine, const std::vector<uint32_t> &board, const double seconds) -> double {
+    uint64_t generations = 0;
+    double elapsed = 0;
+    do {
+        engine.reset(board);
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < GENERATIONS_PER_SEED; ++i) engine.step();
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        generations += GENERATIONS_PER_SEED;
+    } while (elapsed < seconds);
+    return generations / elapsed;
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    std::size_t threads = argc >= 2 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    uint32_t size = argc >= 3 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 4096;
+    double seconds = argc >= 4 ? std::atof(argv[3]) : 1.0;
+    if (threads < 1) threads = 1;
+    if (size < 1) size = 1;
+
+    std::vector<uint32_t> board = random_board(static_cast<uint64_t>(size) * size);
+    std::printf("%ux%u, %u hardware threads\n\n", size, size, std::thread::hardware_concurrency());
+    std::printf("threads        gen/s   speedup\n");
+
+    double single = 0;
+    for (std::size_t t = 1; t <= threads; ++t) {
+        gol_bitboard<uint32_t> engine(size, size, t);
+        double gps = generations_per_second(engine, board, seconds);
+        if (t == 1) single = gps;
+        std::printf("%7zu %12.1f %8.2fx\n", t, gps, gps / single);
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file gol_thread_pool.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief A fixed pool of threads that runs a batch of indexed tasks and waits for all of them
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * run(n, task) hands out the indexes 0..n-1 through an atomic counter to
+ * the workers and to the calling thread, then blocks until every worker is
+ * done. The return of run() is therefore the barrier between two batches,
+ * e.g. two generations of a board.
+ *
+ */
+
+#ifndef GOL_THREAD_POOL_HPP
+#define GOL_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class gol_thread_pool {
+
+/**
+ * Constructors and class vars
+ *
+ */
+
+private:
+
+    using task_fn = auto (*)(const void *, const std::size_t) -> void;
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+    // Current batch, guarded by mutex_
+    task_fn task_fn_{nullptr};
+    const void *task_{nullptr};
+    std::size_t size_of_batch_{0};
+    std::size_t batch_{0};
+    std::size_t busy_{0};
+    bool is_stopping_{false};
+
+    std::atomic<std::size_t> next_task_{0};
+
+public:
+
+    // The calling thread also runs tasks,
+    // so threads - 1 workers are started
+
+    gol_thread_pool(const std::size_t threads = std::thread::hardware_concurrency()) {
+        for (std::size_t i = 1; i < threads; ++i)
+            workers_.emplace_back([this]() {work_loop();});
+    }
+
+    gol_thread_pool(const gol_thread_pool &) = delete;
+    auto operator=(const gol_thread_pool &) -> gol_thread_pool & = delete;
+
+    ~gol_thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_stopping_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto &w : workers_) w.join();
+    }
+
+/**
+ * Public Interfaces
+ *
+ */
+
+public:
+
+    inline auto size() const -> std::size_t {
+        return workers_.size() + 1;
+    }
+
+    template<typename task_type>
+    auto run(const std::size_t n, const task_type &task) -> void {
+        if (workers_.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; ++i) task(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_fn_ = [](const void *t, const std::size_t i) -> void {(*static_cast<const task_type *>(t))(i);};
+            task_ = &task;
+            size_of_batch_ = n;
+            next_task_.store(0, std::memory_order_relaxed);
+            busy_ = workers_.size();
+            ++batch_;
+        }
+        start_cv_.notify_all();
+
+        run_tasks(task_fn_, task_, n);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() {return busy_ == 0;});
+    }
+
+private:
+
+    auto run_tasks(const task_fn fn, const void *task, const std::size_t n) -> void {
+        for (std::size_t i; (i = next_task_.fetch_add(1, std::memory_order_relaxed)) < n;)
+            fn(task, i);
+    }
+
+    auto work_loop() -> void {
+        std::size_t seen_batch = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            start_cv_.wait(lock, [&]() {return is_stopping_ || batch_ != seen_batch;});
+            if (is_stopping_) return;
+            seen_batch = batch_;
+            task_fn fn = task_fn_;
+            const void *task = task_;
+            std::size_t n = size_of_batch_;
+
+            lock.unlock();
+            run_tasks(fn, task, n);
+            lock.lock();
+
+            if (--busy_ == 0) done_cv_.notify_one();
+        }
+    }
+};
+
+#endif
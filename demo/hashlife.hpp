@@ -0,0 +1,110 @@
+/**
+ * @file hashlife.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Derived from text_video_anim to fast-forward a Game of Life pattern with HashLife.
+ * @version 0.1
+ * @date 2022-06-10
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *  
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef HASHLIFE_HPP
+#define HASHLIFE_HPP
+
+#include <cstdint>
+#include "gol_hashlife.hpp"
+#include "../include/text_video_anim.hpp"
+
+using namespace g80;
+
+using int_type = int16_t;
+using uint_type = uint16_t;
+
+/**
+ * Demo of HashLife!
+ * Modify the video animation settings here:
+ *
+ */
+
+constexpr uint_type SCREEN_WIDTH = 130;
+constexpr uint_type SCREEN_HEIGHT = 30;
+constexpr uint_type FPS = 10;
+
+// Generations per frame is 2^STEP_LOG and each
+// text cell shows a 2^ZOOM_LOG square of cells
+constexpr uint32_t STEP_LOG = 2;
+constexpr uint32_t ZOOM_LOG = 0;
+
+class hashlife : public text_video_anim<int_type, uint_type> {
+
+/**
+ * Constructors, Destructors and
+ * HashLife instance variables
+ *
+ */
+
+private:
+
+    gol_hashlife universe_;
+
+public:
+
+    hashlife() :
+        text_video_anim<int_type, uint_type>(SCREEN_WIDTH, SCREEN_HEIGHT, FPS) {}
+
+    ~hashlife() = default;
+
+private:
+
+    // The universe centered on the screen
+
+    auto update_render_universe() -> void {
+        int64_t vx = -(static_cast<int64_t>(SCREEN_WIDTH) << ZOOM_LOG) / 2;
+        int64_t vy = -(static_cast<int64_t>(SCREEN_HEIGHT) << ZOOM_LOG) / 2;
+        universe_.rasterize(screen_, vx, vy, ZOOM_LOG);
+    }
+
+/**
+ * Text Video Animation
+ * virtual class overrides
+ *
+ */
+
+public:
+
+    // The R-pentomino, which settles
+    // after 1103 generations
+
+    auto preprocess() -> bool {
+        universe_.set(1, 0, true);
+        universe_.set(2, 0, true);
+        universe_.set(0, 1, true);
+        universe_.set(1, 1, true);
+        universe_.set(1, 2, true);
+        universe_.set_step_log(STEP_LOG);
+        update_render_universe();
+        return true;
+    }
+
+    auto update() -> bool {
+        universe_.step();
+        update_render_universe();
+        return true;
+    }
+};
+
+#endif
@@ -13,6 +13,7 @@
 #define INDEX_HPP
 
 #include <array>
+#include <cstring>
 
 /**
  *              0   1   2   3   4   ....    n-1
@@ -32,31 +33,39 @@ namespace g80 {
 
         auto reset() -> void {
             bin_ptr_ = {invalid_ptr_};
-            memset(bin_loc_.data(), ~0, sizeof(uint_type) * N);
+            std::memset(bin_loc_.data(), ~0, sizeof(uint_type) * N);
         }
 
         auto add_to_bin(uint_type ix) -> bool {
+            if (size() == N || bin_loc_[ix] != invalid_ptr_) return false;
             ix_bin_[++bin_ptr_] = ix;
-            bin_loc[ix] = bin_ptr_;
-            return bin_ptr_ != invalid_ptr_;
+            bin_loc_[ix] = bin_ptr_;
+            return true;
         }
 
         auto remove_from_bin(uint_type ix) -> void {
-            std::swap(ix_bin_[bin_loc_[ix]], ix_bin_[bin_ptr_--]);
+            uint_type loc = bin_loc_[ix];
+            if (loc == invalid_ptr_) return;
+            uint_type last = ix_bin_[bin_ptr_--];
+            ix_bin_[loc] = last;
+            bin_loc_[last] = loc;
             bin_loc_[ix] = invalid_ptr_;
         }
 
-        inline auto size() -> uint_type {
+        inline auto size() const -> uint_type {
             return bin_ptr_ + 1;
         }
 
-        inline auto get_ix_bin() const -> const std::array<uint_type, N> {return ix_bin_;}
-        inline auto bin_loc() const -> const std::array<uint_type, N> {return bin_loc_;}
+        inline auto get_ix_bin() const -> const std::array<uint_type, N> & {return ix_bin_;}
+        inline auto bin_loc() const -> const std::array<uint_type, N> & {return bin_loc_;}
 
-        // TODO: Add forward iterator for list of available indexes in the bin
+        // Indexes in the bin, in no particular order
+
+        inline auto begin() const -> const uint_type * {return ix_bin_.data();}
+        inline auto end() const -> const uint_type * {return ix_bin_.data() + size();}
 
     private:
-        uint_type invalid_ptr_{~static_cast<uint_type>(0);};
+        uint_type invalid_ptr_{static_cast<uint_type>(~static_cast<uint_type>(0))};
         std::array<uint_type, N> ix_bin_;
         std::array<uint_type, N> bin_loc_;
         uint_type bin_ptr_{invalid_ptr_};
@@ -64,4 +73,4 @@ namespace g80 {
     };
 }
 
-#endif
\ No newline at end of file
+#endif
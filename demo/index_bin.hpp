@@ -43,12 +43,23 @@
  * 0 1 2 3 4 5 6 7 8  9 10
  * 5 6 2 7 0 1 8 9 10 4 3  
  * 
+ * Since the bin is always a permutation of 0..N-1, using or unusing
+ * every index at once only moves the partition, which is O(1).
+ * 
+ * Bins of at most small_size indexes keep their bin and mapper inside
+ * the object instead of on the heap.
+ * 
  */
 
 #ifndef INDEX_BIN_HPP
 #define INDEX_BIN_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
+#include <utility>
 
 namespace g80 {
 
@@ -59,8 +70,6 @@ namespace g80 {
      * #define UNSAFE_OPTIM 
      * 
      */
-    
-    #define UNSAFE_OPTIM
 
     /**
      * Template class proper for 
@@ -68,7 +77,7 @@ namespace g80 {
      * 
      */
 
-    template<typename uint_type>
+    template<typename uint_type, std::size_t small_size = 0>
     class index_bin {
     
     /**
@@ -86,6 +95,25 @@ namespace g80 {
 
         "Must be of unsigned integral type");
 
+    /**
+     * A partition of the bin,
+     * usable in a range-for
+     * 
+     */
+
+    public:
+
+        class range {
+        public:
+            range(const uint_type *begin, const uint_type *end) : begin_(begin), end_(end) {}
+            inline auto begin() const -> const uint_type * {return begin_;}
+            inline auto end() const -> const uint_type * {return end_;}
+            inline auto size() const -> std::size_t {return static_cast<std::size_t>(end_ - begin_);}
+            inline auto empty() const -> bool {return begin_ == end_;}
+        private:
+            const uint_type *begin_, *end_;
+        };
+
     /**
      * Constructor, Destructor and 
      * Assignment Helpers
@@ -94,21 +122,34 @@ namespace g80 {
 
     private:
 
+        inline auto is_small() const -> bool {
+            return size_ <= small_size;
+        }
+
         auto del_bin_and_mapper() -> void {
-            delete []bin_;
-            delete []mapper_;
+            if (!is_small()) {
+                delete []bin_;
+                delete []mapper_;
+            }
             bin_ = {nullptr};
             mapper_ = {nullptr};
         }
 
         auto new_bin_and_mapper() -> void {
-            bin_ = new uint_type[size_];
-            mapper_ = new uint_type[size_];
+            if (is_small()) {
+                bin_ = small_.data();
+                mapper_ = small_.data() + small_size;
+            } else {
+                bin_ = new uint_type[size_];
+                mapper_ = new uint_type[size_];
+            }
         }
 
         auto reset_mapper_() -> void {
-
-            for (int i = 0; i < size_; ++i) {bin_[i] = i; mapper_[i] = i;}
+            for (std::size_t i = 0; i < size_; ++i) {
+                bin_[i] = static_cast<uint_type>(i);
+                mapper_[i] = static_cast<uint_type>(i);
+            }
         }
     
         auto copy_index_bin(const index_bin &rhs) -> void {
@@ -116,23 +157,52 @@ namespace g80 {
             std::copy(rhs.mapper_, rhs.mapper_ + size_, mapper_);
         }
 
-        auto reset_rhs(index_bin &rhs) {
+        // Takes over the buffers of rhs, or copies
+        // them if rhs keeps them inside the object
+
+        auto move_index_bin(index_bin &rhs) -> void {
+            size_ = rhs.size_;
+            start_of_unused_ix_ = rhs.start_of_unused_ix_;
+            if (is_small()) {
+                new_bin_and_mapper();
+                copy_index_bin(rhs);
+            } else {
+                bin_ = rhs.bin_;
+                mapper_ = rhs.mapper_;
+            }
+            reset_rhs(rhs);
+        }
+
+        auto reset_rhs(index_bin &rhs) -> void {
             rhs.size_ = {0};
             rhs.start_of_unused_ix_ = {0};
-            rhs.ix_bin_ = {nullptr};
-            rhs.bin_loc_ = {nullptr};
+            rhs.bin_ = {nullptr};
+            rhs.mapper_ = {nullptr};
+        }
+
+        // Swaps the indexes at bin positions a and b
+
+        inline auto swap_bin(const uint_type a, const uint_type b) -> void {
+            uint_type ix_a = bin_[a], ix_b = bin_[b];
+            bin_[a] = ix_b;
+            bin_[b] = ix_a;
+            mapper_[ix_b] = a;
+            mapper_[ix_a] = b;
         }
 
     public:
 
-        auto reset(const uint_type size) {
+        // Resizes the bin, every index unused
+
+        auto reset(const uint_type size) -> void {
+            del_bin_and_mapper();
             size_ = {size};
             start_of_unused_ix_ = {0};
-            del_bin_and_mapper();
+            new_bin_and_mapper();
             reset_mapper_();
         }
 
-        inline auto reset_start_of_unused_ix() {
+        inline auto reset_start_of_unused_ix() -> void {
             start_of_unused_ix_ = {0};
         }
 
@@ -144,29 +214,25 @@ namespace g80 {
 
     public:
         
-        index_bin(uint_type size) : size_(size) {
+        index_bin(const uint_type size) : size_(size) {
             new_bin_and_mapper();
             reset_mapper_();
         }
 
         index_bin(const index_bin &rhs) : 
             size_(rhs.size_), 
-            start_of_unused_ix_(rhs.start_of_unused_ix_), 
-            bin_(new uint_type[size_]), 
-            mapper_(new uint_type[size_]) {
+            start_of_unused_ix_(rhs.start_of_unused_ix_) {
+            new_bin_and_mapper();
             copy_index_bin(rhs);
         }
 
-        index_bin(index_bin &&rhs) : 
-            size_(rhs.size_), 
-            start_of_unused_ix_(rhs.start_of_unused_ix_), 
-            bin_(rhs.bin_), 
-            mapper_(rhs.mapper_) {
-            
-            reset_rhs(rhs);
+        index_bin(index_bin &&rhs) noexcept {
+            move_index_bin(rhs);
         }
 
         auto operator=(const index_bin &rhs) -> index_bin & {
+            if (this == &rhs) return *this;
+
             del_bin_and_mapper();
             
             size_ = rhs.size_;
@@ -176,17 +242,11 @@ namespace g80 {
             return *this;
         }
 
-        auto operator=(index_bin &&rhs) -> index_bin & {
-            
-            del_bin_and_mapper();
-            
-            size_ = rhs.size_;
-            start_of_unused_ix_ = rhs.start_of_unused_ix_;
-            bin_ = rhs.bin_;
-            mapper_ = rhs.mapper_;
-
-            reset_rhs(rhs);
+        auto operator=(index_bin &&rhs) noexcept -> index_bin & {
+            if (this == &rhs) return *this;
 
+            del_bin_and_mapper();
+            move_index_bin(rhs);
             return *this;
         }
 
@@ -201,40 +261,58 @@ namespace g80 {
 
     public:
 
-
-
         auto use(const uint_type ix_to_use) -> bool {
+            #ifndef UNSAFE_OPTIM
             if (ix_to_use >= size_) return false;
+            #endif
             if (mapper_[ix_to_use] < start_of_unused_ix_) return false;
             
-            std::swap(bin_[start_of_unused_ix_], bin_[mapper_[ix_to_use]]);
-            std::swap(mapper_[bin_[mapper_[ix_to_use]]], mapper_[ix_to_use]);
+            swap_bin(start_of_unused_ix_, mapper_[ix_to_use]);
             ++start_of_unused_ix_;
 
             return true;
         }
 
         auto unuse(const uint_type ix_to_unuse) -> bool {
+            #ifndef UNSAFE_OPTIM
             if (ix_to_unuse >= size_) return false;
+            #endif
             if (mapper_[ix_to_unuse] >= start_of_unused_ix_) return false;
             
             --start_of_unused_ix_;
-            std::swap(bin_[start_of_unused_ix_], bin_[mapper_[ix_to_unuse]]);
-            std::swap(mapper_[bin_[mapper_[ix_to_unuse]]], mapper_[ix_to_unuse]);
+            swap_bin(start_of_unused_ix_, mapper_[ix_to_unuse]);
             
             return true;
         }
 
-        auto is_used(const uint_type ix_to_check) -> bool {
-            return ix_to_check < start_of_unused_ix_;
+        inline auto use_all() -> void {
+            start_of_unused_ix_ = size_;
+        }
+
+        inline auto unuse_all() -> void {
+            start_of_unused_ix_ = {0};
+        }
+
+        inline auto is_used(const uint_type ix_to_check) const -> bool {
+            #ifndef UNSAFE_OPTIM
+            if (ix_to_check >= size_) return false;
+            #endif
+            return mapper_[ix_to_check] < start_of_unused_ix_;
         }
-        
 
         inline auto size() const -> uint_type {
             return size_;
         }
 
-        inline auto get_mapper() const -> uint_type * {
+        inline auto size_of_used() const -> uint_type {
+            return start_of_unused_ix_;
+        }
+
+        inline auto size_of_unused() const -> uint_type {
+            return size_ - start_of_unused_ix_;
+        }
+
+        inline auto get_mapper() const -> const uint_type * {
             return mapper_;
         }
 
@@ -243,22 +321,28 @@ namespace g80 {
         }
 
         inline auto cbegin_used() const -> const uint_type * {
-            return start_of_unused_ix_ == 0 ? nullptr : &bin_[0];
+            return bin_;
         }
 
         inline auto cend_used() const -> const uint_type * {
-            return start_of_unused_ix_ == 0 ? nullptr : &bin_[0] + start_of_unused_ix_;
+            return bin_ + start_of_unused_ix_;
         }
 
         inline auto cbegin_unused() const -> const uint_type * {
-            return &bin_[0] + start_of_unused_ix_;
+            return bin_ + start_of_unused_ix_;
         }
         
         inline auto cend_unused() const -> const uint_type * {
-            return &bin_[0] + size_;
+            return bin_ + size_;
         }
 
-    public:
+        inline auto used() const -> range {
+            return {cbegin_used(), cend_used()};
+        }
+
+        inline auto unused() const -> range {
+            return {cbegin_unused(), cend_unused()};
+        }
 
     /**
      * Internal table index variables 
@@ -267,9 +351,10 @@ namespace g80 {
 
     private:
     
-        uint_type size_, start_of_unused_ix_{0};
+        uint_type size_{0}, start_of_unused_ix_{0};
         uint_type *bin_{nullptr}, *mapper_{nullptr};
+        std::array<uint_type, 2 * small_size> small_;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file index_bin_bench.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Insert, erase and iterate of index_bin against std::unordered_set
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include "index_bin.hpp"
+
+using namespace g80;
+
+/**
+ * index_bin_bench [rounds]
+ *
+ * For each capacity, inserts capacity / 2 random keys, iterates
+ * them and erases them again, and prints the best of rounds in
+ * ns per key. uint16_t keys cover capacities up to 64K, the
+ * larger capacities need uint32_t keys
+ *
+ */
+
+// Keeps the fastest of the runs of f, in ns per key
+
+template<typename F>
+auto time_ns(double &best, const std::size_t n, F &&f) -> void {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    if (ns < best) best = ns;
+}
+
+template<typename uint_type>
+auto bench(const std::size_t capacity, const int rounds) -> void {
+    // 64K does not fit in a uint16_t, so its last index is left out
+    std::size_t size = std::min<std::size_t>(capacity, std::numeric_limits<uint_type>::max());
+
+    std::mt19937 rng(1);
+    std::vector<uint_type> keys(capacity / 2);
+    for (auto &k : keys) k = static_cast<uint_type>(rng() % size);
+
+    index_bin<uint_type> bin(static_cast<uint_type>(size));
+    std::unordered_set<uint_type> set;
+    volatile uint64_t sink = 0;
+
+    double bin_insert = 1e300, bin_iterate = 1e300, bin_erase = 1e300;
+    double set_insert = 1e300, set_iterate = 1e300, set_erase = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        time_ns(bin_insert, keys.size(), [&]() {for (auto k : keys) bin.use(k);});
+        time_ns(bin_iterate, keys.size(), [&]() {uint64_t s = 0; for (auto k : bin.used()) s += k; sink = s;});
+        time_ns(bin_erase, keys.size(), [&]() {for (auto k : keys) bin.unuse(k);});
+
+        time_ns(set_insert, keys.size(), [&]() {for (auto k : keys) set.insert(k);});
+        time_ns(set_iterate, keys.size(), [&]() {uint64_t s = 0; for (auto k : set) s += k; sink = s;});
+        time_ns(set_erase, keys.size(), [&]() {for (auto k : keys) set.erase(k);});
+    }
+
+    std::printf("%8zu  uint%-2zu_t   %6.2f %6.2f   %6.2f %6.2f   %6.2f %6.2f\n",
+        capacity, 8 * sizeof(uint_type),
+        bin_insert, set_insert, bin_iterate, set_iterate, bin_erase, set_erase);
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    int rounds = argc >= 2 ? std::atoi(argv[1]) : 5;
+    if (rounds < 1) rounds = 1;
+
+    std::printf("ns per key, index_bin vs std::unordered_set, best of %d\n\n", rounds);
+    std::printf("capacity  key          insert          iterate          erase\n");
+    bench<uint16_t>(4096, rounds);
+    bench<uint16_t>(16384, rounds);
+    bench<uint16_t>(65536, rounds);
+    bench<uint32_t>(262144, rounds);
+    bench<uint32_t>(1048576, rounds);
+}
@@ -0,0 +1,451 @@
+/**
+ * @file text_clip.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Records text_video_anim frames into a delta-encoded clip and plays them back
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * A clip is written front to back while the animation runs, all fields
+ * little-endian:
+ *
+ *  magic       4   "TXCL"
+ *  version     1   1
+ *  reserved    3   0
+ *  width       4
+ *  height      4
+ *  interval    4   frames from one keyframe to the next
+ *  per frame:
+ *    kind      1   CLIP_KEYFRAME or CLIP_DELTA
+ *    per plane, color, text then mask:
+ *      length  4   bytes of run-length code that follow
+ *      code    length
+ *    crc       4   CRC-32 of the frame record before it
+ *
+ * A keyframe holds the run-length code of the planes themselves, a delta
+ * the code of the planes XOR the previous frame, so that unchanged cells
+ * are runs of zeros. The run-length code is the one of text_image::save().
+ *
+ * close() appends the index of the keyframes and a trailer:
+ *
+ *  magic       4   "TXCI"
+ *  count       4
+ *  per keyframe:
+ *    frame     4
+ *    offset    8   of its record from the start of the file
+ *  crc         4   CRC-32 of the index before it
+ *  at          8   offset of the index
+ *  frames      4
+ *  magic       4   "TXCE"
+ *
+ * The player binary searches the index for the keyframe at or before a
+ * frame and applies the deltas after it. A clip without a trailer, e.g.
+ * from a program that did not close() it, is indexed by walking its
+ * records instead, up to the last whole one.
+ *
+ */
+
+#ifndef TEXT_CLIP_HPP
+#define TEXT_CLIP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "text_image.hpp"
+
+namespace g80 {
+
+    constexpr char text_clip_magic[4] {'T', 'X', 'C', 'L'};
+    constexpr char text_clip_index_magic[4] {'T', 'X', 'C', 'I'};
+    constexpr char text_clip_end_magic[4] {'T', 'X', 'C', 'E'};
+    constexpr uint8_t text_clip_version = 1;
+    enum text_clip_record : uint8_t {CLIP_KEYFRAME = 'K', CLIP_DELTA = 'D'};
+
+    struct text_clip_keyframe {
+        uint32_t frame;
+        uint64_t offset;
+    };
+
+    template<typename int_type, typename uint_type>
+    class text_clip_recorder {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_clip_recorder(const std::string &filename, const uint32_t keyframe_interval = 60) :
+            file_(filename, std::ios::binary),
+            keyframe_interval_(validator_if_less_than<uint32_t, 1>(keyframe_interval)) {
+
+            file_.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        }
+
+        text_clip_recorder(const text_clip_recorder &) = delete;
+        auto operator=(const text_clip_recorder &) -> text_clip_recorder & = delete;
+
+        ~text_clip_recorder() {
+            try {close();} catch (...) {}
+        }
+
+    private:
+
+        std::ofstream file_;
+        uint32_t keyframe_interval_;
+        uint_type w_{0}, h_{0};
+
+        // The planes of the last frame, color, text
+        // then mask, and the XOR of the next one
+        std::vector<uint8_t> prev_, diff_;
+        std::vector<char> out_;
+
+        std::vector<text_clip_keyframe> keyframes_;
+        uint64_t offset_{0};
+        std::size_t recorded_{0};
+        bool is_closed_{false};
+
+    // Getters
+
+    public:
+
+        inline auto recorded() const -> std::size_t {
+            return recorded_;
+        }
+
+        // Bytes written so far, without the index
+
+        inline auto bytes_written() const -> uint64_t {
+            return offset_;
+        }
+
+    // Sink
+
+    public:
+
+        auto operator()(const std::size_t, const text_image<int_type, uint_type> &screen) -> void {
+            if (is_closed_) throw std::runtime_error(std::string("The text_clip_recorder is closed."));
+            if (recorded_ == 0) write_header(screen.width(), screen.height());
+            else if (screen.width() != w_ || screen.height() != h_) throw std::runtime_error(std::string("Clip frames must be of the same size."));
+
+            bool is_key = recorded_ % keyframe_interval_ == 0;
+            if (is_key) keyframes_.push_back({static_cast<uint32_t>(recorded_), offset_});
+
+            out_.clear();
+            out_.push_back(static_cast<char>(is_key ? CLIP_KEYFRAME : CLIP_DELTA));
+
+            uint8_t *prev = prev_.data();
+            auto append_plane = [&](const uint8_t *data, const std::size_t n) {
+                std::size_t at = out_.size();
+                append_le32(out_, 0);
+                if (is_key) {
+                    rle_encode(data, n, out_);
+                } else {
+                    for (std::size_t i = 0; i < n; ++i) diff_[i] = data[i] ^ prev[i];
+                    rle_encode(diff_.data(), n, out_);
+                }
+                patch_le32(out_, at, static_cast<uint32_t>(out_.size() - at - 4));
+                std::memcpy(prev, data, n);
+                prev += n;
+            };
+
+            append_plane(screen.craw_color_ptr().get(), screen.size());
+            append_plane(screen.craw_text_ptr().get(), screen.size());
+            append_plane(screen.craw_mask8bit_ptr().get(), screen.size_mask8bit());
+
+            crc32 crc;
+            crc.update(out_.data(), out_.size());
+            append_le32(out_, crc.value());
+
+            file_.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+            offset_ += out_.size();
+            ++recorded_;
+        }
+
+        // Appends the index and the trailer. Called by
+        // the destructor if it was not called before
+
+        auto close() -> void {
+            if (is_closed_) return;
+            is_closed_ = true;
+            if (recorded_ > 0) {
+                out_.clear();
+                out_.insert(out_.end(), text_clip_index_magic, text_clip_index_magic + 4);
+                append_le32(out_, static_cast<uint32_t>(keyframes_.size()));
+                for (const auto &k : keyframes_) {
+                    append_le32(out_, k.frame);
+                    append_le64(out_, k.offset);
+                }
+
+                crc32 crc;
+                crc.update(out_.data(), out_.size());
+                append_le32(out_, crc.value());
+                append_le64(out_, offset_);
+                append_le32(out_, static_cast<uint32_t>(recorded_));
+                out_.insert(out_.end(), text_clip_end_magic, text_clip_end_magic + 4);
+                file_.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+            }
+            file_.close();
+        }
+
+    private:
+
+        auto write_header(const uint_type w, const uint_type h) -> void {
+            w_ = w;
+            h_ = h;
+            std::size_t size = static_cast<std::size_t>(w) * h;
+            prev_.assign(2 * size + (size + 7) / 8, 0);
+            diff_.assign(size, 0);
+            out_.reserve(32 + (2 * size + (size + 7) / 8) * 129 / 128);
+
+            out_.clear();
+            out_.insert(out_.end(), text_clip_magic, text_clip_magic + 4);
+            out_.push_back(static_cast<char>(text_clip_version));
+            out_.insert(out_.end(), 3, 0);
+            append_le32(out_, w);
+            append_le32(out_, h);
+            append_le32(out_, keyframe_interval_);
+            file_.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+            offset_ = out_.size();
+        }
+    };
+
+    template<typename int_type, typename uint_type>
+    class text_clip_player {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_clip_player(const std::string &filename) : file_(filename, std::ios::binary) {
+            if (!file_) throw std::runtime_error(std::string("Unable to open ") + filename + ".");
+
+            crc32 ignored;
+            uint8_t header[20];
+            read_exact(file_, header, sizeof(header), ignored);
+            if (std::memcmp(header, text_clip_magic, 4) != 0) throw std::runtime_error(std::string("Not a text_clip file."));
+            if (header[4] != text_clip_version) throw std::runtime_error(std::string("Unsupported text_clip version."));
+
+            uint32_t w = get_le32(header + 8), h = get_le32(header + 12);
+            uint64_t size = static_cast<uint64_t>(w) * h;
+            if (w < 1 || h < 1 || size > static_cast<uint64_t>(static_cast<uint_type>(~static_cast<uint_type>(0))))
+                throw std::runtime_error(std::string("Invalid parameter."));
+            keyframe_interval_ = get_le32(header + 16);
+
+            frame_ = text_image<int_type, uint_type>(static_cast<int_type>(w), static_cast<int_type>(h));
+            diff_.assign(static_cast<std::size_t>(size), 0);
+
+            file_.seekg(0, std::ios::end);
+            size_of_file_ = static_cast<uint64_t>(file_.tellg());
+            if (!read_index()) scan_records();
+            if (frames_ > 0) seek(0);
+        }
+
+        text_clip_player(const text_clip_player &) = delete;
+        auto operator=(const text_clip_player &) -> text_clip_player & = delete;
+
+        ~text_clip_player() = default;
+
+    private:
+
+        std::ifstream file_;
+        uint64_t size_of_file_{0};
+        uint32_t keyframe_interval_{0};
+        std::vector<text_clip_keyframe> keyframes_;
+        std::size_t frames_{0};
+
+        // frame_ holds frame position_, and the
+        // file is at the record of the one after
+        text_image<int_type, uint_type> frame_;
+        std::vector<uint8_t> diff_;
+        std::size_t position_{0};
+        bool has_frame_{false};
+
+    // Getters
+
+    public:
+
+        inline auto frames() const -> std::size_t {
+            return frames_;
+        }
+
+        inline auto position() const -> std::size_t {
+            return position_;
+        }
+
+        inline auto keyframe_interval() const -> uint32_t {
+            return keyframe_interval_;
+        }
+
+        inline auto width() const -> uint_type {
+            return frame_.width();
+        }
+
+        inline auto height() const -> uint_type {
+            return frame_.height();
+        }
+
+        inline auto frame() const -> const text_image<int_type, uint_type> & {
+            return frame_;
+        }
+
+    // Playback
+
+    public:
+
+        // Decodes from the keyframe at or before frame, unless
+        // frame is ahead of the position within the same run
+
+        auto seek(const std::size_t frame) -> void {
+            if (frame >= frames_) throw std::out_of_range(std::string("No such frame in the text_clip."));
+
+            auto key = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame,
+                [](const std::size_t f, const text_clip_keyframe &k) {return f < k.frame;}) - 1;
+
+            if (!(has_frame_ && position_ <= frame && position_ >= key->frame)) {
+                file_.clear();
+                file_.seekg(static_cast<std::streamoff>(key->offset));
+                position_ = key->frame;
+                decode_record();
+                has_frame_ = true;
+            }
+            while (position_ < frame) {
+                ++position_;
+                decode_record();
+            }
+        }
+
+        // Decodes the next frame, false at the end of the clip
+
+        auto next() -> bool {
+            if (!has_frame_ || position_ + 1 >= frames_) return false;
+            ++position_;
+            decode_record();
+            return true;
+        }
+
+    private:
+
+        auto decode_record() -> void {
+            crc32 crc;
+            uint8_t kind;
+            read_exact(file_, &kind, 1, crc);
+            if (kind != CLIP_KEYFRAME && kind != CLIP_DELTA) throw std::runtime_error(std::string("Corrupt text_clip file."));
+
+            auto decode_plane = [&](uint8_t *to, const std::size_t n) {
+                uint8_t length[4];
+                read_exact(file_, length, 4, crc);
+                if (kind == CLIP_KEYFRAME) {
+                    rle_decode(file_, to, n, get_le32(length), crc);
+                } else {
+                    rle_decode(file_, diff_.data(), n, get_le32(length), crc);
+                    for (std::size_t i = 0; i < n; ++i) to[i] ^= diff_[i];
+                }
+            };
+
+            decode_plane(frame_.raw_color_ptr().get(), frame_.size());
+            decode_plane(frame_.raw_text_ptr().get(), frame_.size());
+            decode_plane(frame_.raw_mask8bit_ptr().get(), frame_.size_mask8bit());
+
+            uint32_t expected = crc.value();
+            uint8_t stored[4];
+            read_exact(file_, stored, 4, crc);
+            if (get_le32(stored) != expected) throw std::runtime_error(std::string("CRC mismatch in text_clip file."));
+        }
+
+        // Reads the index written by close(), false if there is none
+
+        auto read_index() -> bool {
+            if (size_of_file_ < 20 + 28) return false;
+
+            crc32 crc;
+            uint8_t trailer[16];
+            file_.clear();
+            file_.seekg(static_cast<std::streamoff>(size_of_file_ - 16));
+            read_exact(file_, trailer, 16, crc);
+            if (std::memcmp(trailer + 12, text_clip_end_magic, 4) != 0) return false;
+
+            uint64_t at = get_le64(trailer);
+            uint32_t frames = get_le32(trailer + 8);
+            if (at < 20 || at > size_of_file_ - 16 - 12) throw std::runtime_error(std::string("Corrupt text_clip file."));
+
+            crc = crc32();
+            uint8_t head[8];
+            file_.seekg(static_cast<std::streamoff>(at));
+            read_exact(file_, head, 8, crc);
+            uint32_t count = get_le32(head + 4);
+            if (std::memcmp(head, text_clip_index_magic, 4) != 0 || count < 1 || count > frames ||
+                static_cast<uint64_t>(count) * 12 != size_of_file_ - 16 - 4 - 8 - at)
+                throw std::runtime_error(std::string("Corrupt text_clip file."));
+
+            std::vector<uint8_t> entries(static_cast<std::size_t>(count) * 12);
+            read_exact(file_, entries.data(), entries.size(), crc);
+            uint32_t expected = crc.value();
+            uint8_t stored[4];
+            read_exact(file_, stored, 4, crc);
+            if (get_le32(stored) != expected) throw std::runtime_error(std::string("CRC mismatch in text_clip file."));
+
+            keyframes_.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                keyframes_[i] = {get_le32(&entries[i * 12]), get_le64(&entries[i * 12 + 4])};
+                if (keyframes_[i].offset >= at || (i == 0 ? keyframes_[i].frame != 0 : keyframes_[i].frame <= keyframes_[i - 1].frame))
+                    throw std::runtime_error(std::string("Corrupt text_clip file."));
+            }
+            frames_ = frames;
+            return true;
+        }
+
+        // Indexes a clip that was not closed by walking the length
+        // fields of its records, stopping at the first partial one
+
+        auto scan_records() -> void {
+            uint64_t at = 20;
+            for (;;) {
+                uint64_t next = at + 1;
+                if (next > size_of_file_) break;
+
+                file_.clear();
+                file_.seekg(static_cast<std::streamoff>(at));
+                int kind = file_.rdbuf()->sbumpc();
+                if (kind != CLIP_KEYFRAME && kind != CLIP_DELTA) break;
+
+                bool is_whole = true;
+                for (int plane = 0; plane < 3 && is_whole; ++plane) {
+                    uint8_t length[4];
+                    if (next + 4 > size_of_file_ || file_.rdbuf()->sgetn(reinterpret_cast<char *>(length), 4) != 4) {is_whole = false; break;}
+                    next += 4 + get_le32(length);
+                    if (next > size_of_file_) {is_whole = false; break;}
+                    file_.seekg(static_cast<std::streamoff>(next));
+                }
+                if (!is_whole || next + 4 > size_of_file_) break;
+
+                if (kind == CLIP_KEYFRAME) keyframes_.push_back({static_cast<uint32_t>(frames_), at});
+                else if (keyframes_.empty()) throw std::runtime_error(std::string("Corrupt text_clip file."));
+                ++frames_;
+                at = next + 4;
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file text_frame_capture.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Sinks that keep the frames of a headless text_video_anim run
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * A sink is any callable taking (frame number, screen), so a lambda works
+ * as well. text_frame_ring keeps the last N frames in memory and
+ * text_frame_file appends every frame to a file in the format of
+ * text_image::save(), to be read back one by one with text_image::load()
+ * or, when saved with ENCODE_RAW, mapped as a whole with text_image_map.
+ *
+ */
+
+#ifndef TEXT_FRAME_CAPTURE_HPP
+#define TEXT_FRAME_CAPTURE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "text_image.hpp"
+
+namespace g80 {
+
+    template<typename int_type, typename uint_type>
+    class text_frame_ring {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_frame_ring(const std::size_t capacity) : frames_(validator_if_less_than<std::size_t, 1>(capacity)) {}
+
+        ~text_frame_ring() = default;
+
+    private:
+
+        std::vector<text_image<int_type, uint_type>> frames_;
+        std::size_t captured_{0};
+
+    // Getters
+
+    public:
+
+        inline auto capacity() const -> std::size_t {
+            return frames_.size();
+        }
+
+        // Frames captured so far, of which
+        // the last capacity() are kept
+
+        inline auto captured() const -> std::size_t {
+            return captured_;
+        }
+
+        inline auto has_frame(const std::size_t frame) const -> bool {
+            return frame < captured_ && frame + frames_.size() >= captured_;
+        }
+
+        auto get_frame(const std::size_t frame) const -> const text_image<int_type, uint_type> & {
+            if (!has_frame(frame)) throw std::runtime_error("Frame is no longer in the ring.");
+            return frames_[frame % frames_.size()];
+        }
+
+    // Sink
+
+    public:
+
+        auto operator()(const std::size_t frame, const text_image<int_type, uint_type> &screen) -> void {
+            frames_[frame % frames_.size()] = screen;
+            captured_ = frame + 1;
+        }
+    };
+
+    template<typename int_type, typename uint_type>
+    class text_frame_file {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_frame_file(const std::string &filename, const text_image_encoding encoding = ENCODE_RLE) :
+            file_(filename, std::ios::binary),
+            encoding_(encoding) {
+
+            file_.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        }
+
+        ~text_frame_file() = default;
+
+    private:
+
+        std::ofstream file_;
+        text_image_encoding encoding_;
+        std::size_t captured_{0};
+
+    // Getters
+
+    public:
+
+        inline auto captured() const -> std::size_t {
+            return captured_;
+        }
+
+    // Sink
+
+    public:
+
+        auto operator()(const std::size_t, const text_image<int_type, uint_type> &screen) -> void {
+            screen.save(file_, encoding_);
+            ++captured_;
+        }
+    };
+}
+
+#endif
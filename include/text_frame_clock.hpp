@@ -0,0 +1,234 @@
+/**
+ * @file text_frame_clock.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Fixed timestep frame scheduler on a monotonic clock for text_video_anim
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Frames are due at absolute deadlines start + k * frame_time, so time
+ * spent rendering or updating never pushes the next frame back and the
+ * rate does not drift. Waiting sleeps until just before the deadline and
+ * spins the rest, since a sleep alone can wake a scheduler tick late.
+ * The sleep can be replaced, e.g. by text_input::wait_until() so that
+ * a key ends it early.
+ *
+ * Updates run on a fixed timestep: the time elapsed since the last frame
+ * is added to an accumulator and one update is due for every frame_time
+ * in it. When frames overrun, the overload policy decides what happens:
+ *
+ *  FRAME_SKIP      several updates run per presented frame, up to
+ *                  max_updates_per_frame, and the simulation keeps
+ *                  real time at a lower frame rate
+ *  SLOW_MOTION     at most one update runs per frame and the
+ *                  simulation slows down instead
+ *
+ * Time beyond what the policy allows is dropped rather than carried, so
+ * an overloaded loop never falls further and further behind.
+ *
+ */
+
+#ifndef TEXT_FRAME_CLOCK_HPP
+#define TEXT_FRAME_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace g80 {
+
+    enum frame_overload {FRAME_SKIP, SLOW_MOTION};
+
+    class text_frame_clock {
+
+    // Constructors and instance vars
+
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        text_frame_clock(const uint32_t fps, const frame_overload overload = FRAME_SKIP, const uint32_t max_updates_per_frame = 5) :
+            frame_time_(std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / (fps < 1 ? 1 : fps)),
+            overload_(overload),
+            max_updates_per_frame_(max_updates_per_frame < 1 ? 1 : max_updates_per_frame) {}
+
+        ~text_frame_clock() = default;
+
+    private:
+
+        clock::duration frame_time_;
+        frame_overload overload_;
+        uint32_t max_updates_per_frame_;
+        clock::duration spin_{std::chrono::microseconds(1500)};
+
+        clock::time_point deadline_, last_update_, last_frame_;
+        clock::duration accumulator_{0};
+
+        // Stats since start()
+        uint64_t frames_{0}, updates_{0}, dropped_updates_{0}, late_frames_{0};
+        double avg_frame_time_{0}, avg_jitter_{0};
+
+    // Setters
+
+    public:
+
+        inline auto set_overload(const frame_overload overload) -> void {
+            overload_ = overload;
+        }
+
+        inline auto set_max_updates_per_frame(const uint32_t n) -> void {
+            max_updates_per_frame_ = n < 1 ? 1 : n;
+        }
+
+        // How long before a deadline sleeping
+        // stops and spinning takes over
+
+        inline auto set_spin(const clock::duration spin) -> void {
+            spin_ = spin;
+        }
+
+    // Getters
+
+    public:
+
+        inline auto frame_time() const -> clock::duration {
+            return frame_time_;
+        }
+
+        inline auto overload() const -> frame_overload {
+            return overload_;
+        }
+
+        inline auto frames() const -> uint64_t {
+            return frames_;
+        }
+
+        inline auto updates() const -> uint64_t {
+            return updates_;
+        }
+
+        // Updates given up under overload
+
+        inline auto dropped_updates() const -> uint64_t {
+            return dropped_updates_;
+        }
+
+        // Frames that reached wait() after their deadline
+
+        inline auto late_frames() const -> uint64_t {
+            return late_frames_;
+        }
+
+        // Achieved frames per second and the mean deviation of a
+        // frame from frame_time() in seconds, both as moving averages
+
+        inline auto fps() const -> double {
+            return avg_frame_time_ > 0 ? 1.0 / avg_frame_time_ : 0;
+        }
+
+        inline auto jitter() const -> double {
+            return avg_jitter_;
+        }
+
+    // Scheduling
+
+    public:
+
+        // One update is due on the first frame. The half frame left
+        // over keeps the jitter of a frame from moving an update
+        // into the frame before or after it
+
+        auto start() -> void {
+            clock::time_point now = clock::now();
+            deadline_ = last_update_ = last_frame_ = now;
+            accumulator_ = frame_time_ + frame_time_ / 2;
+            frames_ = updates_ = dropped_updates_ = late_frames_ = 0;
+            avg_frame_time_ = avg_jitter_ = 0;
+        }
+
+        // Number of fixed timestep updates to run this frame
+
+        auto updates_due() -> uint32_t {
+            clock::time_point now = clock::now();
+            accumulator_ += now - last_update_;
+            last_update_ = now;
+
+            uint64_t due = static_cast<uint64_t>(accumulator_ / frame_time_);
+            uint64_t allowed = overload_ == SLOW_MOTION ? 1 : max_updates_per_frame_;
+            uint64_t n = due < allowed ? due : allowed;
+
+            accumulator_ -= frame_time_ * static_cast<clock::rep>(due);
+            dropped_updates_ += due - n;
+            updates_ += n;
+            return static_cast<uint32_t>(n);
+        }
+
+        // Blocks until the next frame is due
+
+        auto wait() -> void {
+            wait([](const clock::time_point t) -> bool {std::this_thread::sleep_until(t); return false;});
+        }
+
+        // Same as wait(), but sleeps through sleep_until(t), which may
+        // return true to end the wait early, e.g. on input. Returns
+        // false if the wait ended early and the frame is not over yet
+
+        template<typename sleep_until_type>
+        auto wait(const sleep_until_type &sleep_until) -> bool {
+            clock::time_point deadline = deadline_ + frame_time_;
+
+            clock::time_point now = clock::now();
+            if (now >= deadline) {
+
+                // Overrun: start over from now instead of
+                // rushing out frames to catch up
+                deadline_ = now;
+                ++late_frames_;
+
+            } else {
+                if (deadline - now > spin_ && sleep_until(deadline - spin_)) return false;
+                while ((now = clock::now()) < deadline) {}
+                deadline_ = deadline;
+            }
+
+            record_frame(now);
+            return true;
+        }
+
+    private:
+
+        auto record_frame(const clock::time_point now) -> void {
+            static constexpr double weight = 1.0 / 16;
+            double elapsed = std::chrono::duration<double>(now - last_frame_).count();
+            double deviation = elapsed - std::chrono::duration<double>(frame_time_).count();
+            last_frame_ = now;
+
+            if (frames_++ == 0) {
+                avg_frame_time_ = elapsed;
+                avg_jitter_ = deviation < 0 ? -deviation : deviation;
+            } else {
+                avg_frame_time_ += (elapsed - avg_frame_time_) * weight;
+                avg_jitter_ += ((deviation < 0 ? -deviation : deviation) - avg_jitter_) * weight;
+            }
+        }
+    };
+}
+
+#endif
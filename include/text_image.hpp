@@ -29,12 +29,15 @@
 #include <fstream>
 #include <memory>
 #include <cstdint>
-#include <functional>
-#include <sstream>
-#include <unordered_map>
+#include <cstring>
+#include <cmath>
 #include <tuple>
 #include <vector>
+#include <array>
+#include <algorithm>
 #include <type_traits>
+#include "text_image_codec.hpp"
+#include "text_output.hpp"
 
 namespace g80 {
 
@@ -62,6 +65,159 @@ namespace g80 {
         T n_;
     };
 
+    /**
+     * Mask bit helpers to move up to 64 bits of a
+     * mask8bit plane at a time. Bit ix lives in byte
+     * ix / 8 at offset ix % 8 (LSB first).
+     * 
+     * The word-at-a-time helpers load 8 plane bytes into
+     * a uint64_t and assume a little-endian host.
+     * 
+     */
+
+    inline auto get_mask_bits(const mask8bit *mask8bit, const std::size_t ix, const std::size_t n) -> uint64_t {
+        const std::size_t ix8 = ix / 8;
+        const std::size_t offset = ix % 8;
+        const std::size_t nbytes = (offset + n + 7) / 8;
+        uint64_t value = 0;
+        for (std::size_t i = 0, imax = nbytes < 8 ? nbytes : 8; i < imax; ++i) 
+            value |= static_cast<uint64_t>(mask8bit[ix8 + i]) << (8 * i);
+        value >>= offset;
+        if (nbytes > 8) value |= static_cast<uint64_t>(mask8bit[ix8 + 8]) << (64 - offset);
+        return n >= 64 ? value : value & ((static_cast<uint64_t>(1) << n) - 1);
+    }
+
+    constexpr auto make_expand_bits_to_bytes() -> std::array<uint64_t, 256> {
+        std::array<uint64_t, 256> table {};
+        for (std::size_t i = 0; i < 256; ++i)
+            for (std::size_t b = 0; b < 8; ++b)
+                if (i & (1 << b)) table[i] |= static_cast<uint64_t>(0xff) << (8 * b);
+        return table;
+    }
+
+    // Bit b of the index becomes byte b of the entry (0x00 or 0xff)
+    constexpr std::array<uint64_t, 256> expand_bits_to_bytes = make_expand_bits_to_bytes();
+
+    inline auto blend_word(uint8_t *dst, const uint8_t *src, const uint64_t select) -> void {
+        uint64_t d, s;
+        std::memcpy(&d, dst, sizeof(d));
+        std::memcpy(&s, src, sizeof(s));
+        d = (s & select) | (d & ~select);
+        std::memcpy(dst, &d, sizeof(d));
+    }
+
+    inline auto set_mask_bits(mask8bit *mask8bit, std::size_t ix, std::size_t n, uint64_t value) -> void {
+        while (n > 0) {
+            const std::size_t offset = ix % 8;
+            const std::size_t k = 8 - offset < n ? 8 - offset : n;
+            const uint8_t bits = static_cast<uint8_t>(((1u << k) - 1) << offset);
+            mask8bit[ix / 8] = (mask8bit[ix / 8] & ~bits) | (static_cast<uint8_t>(value << offset) & bits);
+            value >>= k;
+            ix += k;
+            n -= k;
+        }
+    }
+
+    inline auto copy_mask_bits(mask8bit *dst, std::size_t dix, const mask8bit *src, std::size_t six, std::size_t n) -> void {
+        while (n > 0) {
+            const std::size_t k = n < 64 ? n : 64;
+            set_mask_bits(dst, dix, k, get_mask_bits(src, six, k));
+            dix += k;
+            six += k;
+            n -= k;
+        }
+    }
+
+    // Moves n bits like memmove, so the ranges may overlap
+    inline auto move_mask_bits(mask8bit *dst, std::size_t dix, const mask8bit *src, std::size_t six, std::size_t n) -> void {
+        if (dst != src || dix <= six) {
+            copy_mask_bits(dst, dix, src, six, n);
+            return;
+        }
+        while (n > 0) {
+            const std::size_t k = n < 64 ? n : 64;
+            n -= k;
+            set_mask_bits(dst, dix + n, k, get_mask_bits(src, six + n, k));
+        }
+    }
+
+    inline auto fill_mask_bits(mask8bit *mask8bit, std::size_t ix, std::size_t n, const mask_bit m) -> void {
+        const uint64_t value = m ? ~static_cast<uint64_t>(0) : 0;
+        std::size_t head = (8 - ix % 8) % 8;
+        if (head > n) head = n;
+        set_mask_bits(mask8bit, ix, head, value);
+        ix += head;
+        n -= head;
+        std::memset(&mask8bit[ix / 8], static_cast<int>(value & 0xff), n / 8);
+        set_mask_bits(mask8bit, ix + n / 8 * 8, n % 8, value);
+    }
+
+    inline auto reverse_bits(uint64_t v) -> uint64_t {
+        v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+        v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+        v = ((v >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((v & 0x0f0f0f0f0f0f0f0fULL) << 4);
+        v = ((v >> 8) & 0x00ff00ff00ff00ffULL) | ((v & 0x00ff00ff00ff00ffULL) << 8);
+        v = ((v >> 16) & 0x0000ffff0000ffffULL) | ((v & 0x0000ffff0000ffffULL) << 16);
+        return (v >> 32) | (v << 32);
+    }
+
+    // Packs the result of comparing 8 bytes against 
+    // value into 8 mask bits, byte k into bit k 
+    inline auto match_bytes_to_bits(const uint8_t *bytes, const uint8_t value) -> mask8bit {
+        uint64_t x;
+        std::memcpy(&x, bytes, sizeof(x));
+        x ^= 0x0101010101010101ULL * value;
+        uint64_t y = (x & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL;
+        y = ~(y | x | 0x7f7f7f7f7f7f7f7fULL) >> 7;
+        return static_cast<mask8bit>((y * 0x0102040810204080ULL) >> 56);
+    }
+
+    /**
+     * Octant table for arcs. Octant i spans 45 * i to 45 * (i + 1)
+     * degrees. A midpoint circle step at (x, y) plots the octant's
+     * major coordinate (x or y) times xy_mul, plus the row offset of 
+     * the other coordinate times bxy_mul.
+     * 
+     */
+
+    struct arc_octant {int8_t xy_mul, bxy_mul; bool is_x;};
+    constexpr arc_octant arc_octants[8] {
+        {+1, -1, true}, {+1, -1, false}, {-1, -1, false}, {-1, -1, true},
+        {-1, +1, true}, {-1, +1, false}, {+1, +1, false}, {+1, +1, true}};
+
+    /**
+     * A non-owning window into the planes of a text_image.
+     * Row r of the view starts at cell r * stride of each 
+     * plane and at bit mask_offset + r * stride of the mask.
+     * 
+     */
+
+    template<typename int_type, typename uint_type>
+    class text_image_view {
+    public:
+        text_image_view() = default;
+        text_image_view(const text *text_ptr, const color *color_ptr, const mask8bit *mask8bit_ptr, 
+            const std::size_t mask_offset, const uint_type stride, const uint_type w, const uint_type h) :
+            text_ptr_(text_ptr), color_ptr_(color_ptr), mask8bit_ptr_(mask8bit_ptr), 
+            mask_offset_(mask_offset), stride_(stride), w_(w), h_(h) {}
+
+        inline auto text_ptr() const -> const text * {return text_ptr_;}
+        inline auto color_ptr() const -> const color * {return color_ptr_;}
+        inline auto mask8bit_ptr() const -> const mask8bit * {return mask8bit_ptr_;}
+        inline auto mask_offset() const -> std::size_t {return mask_offset_;}
+        inline auto stride() const -> uint_type {return stride_;}
+        inline auto width() const -> uint_type {return w_;}
+        inline auto height() const -> uint_type {return h_;}
+        inline auto empty() const -> bool {return w_ == 0 || h_ == 0;}
+
+    private:
+        const text *text_ptr_{nullptr};
+        const color *color_ptr_{nullptr};
+        const mask8bit *mask8bit_ptr_{nullptr};
+        std::size_t mask_offset_{0};
+        uint_type stride_{0}, w_{0}, h_{0};
+    };
+
     template<typename int_type, typename uint_type>
     class text_image {
     
@@ -81,11 +237,18 @@ namespace g80 {
 
     protected:
 
-        uint_type w_, h_, size_;
+        uint_type w_{0}, h_{0}, size_{0};
         uptr_color color_{nullptr};
         uptr_text text_{nullptr};
         uint_type size_of_mask8bit_{0};
-        uptr_mask8bit mask8bit_{nullptr};     
+        uptr_mask8bit mask8bit_{nullptr};
+
+        // Reusable work area for rotations,
+        // never copied or moved with the image
+        std::unique_ptr<uint8_t[]> scratch_{nullptr};
+        std::size_t size_of_scratch_{0};
+        std::vector<uint_type> fill_stack_;     
+        std::vector<double> polygon_xs_;
     
     public:
     
@@ -117,15 +280,25 @@ namespace g80 {
             if (m) set_all_mask8bit(); else clear_all_mask8bit();
         }
 
-        text_image(const text_image &rhs) :
-            w_(rhs.w_), h_(rhs.h_), size_(w_ * h_),
-            size_of_mask8bit_(rhs.size_of_mask8bit_) {
-            const color *c = rhs.craw_color().get();
-            std::copy(c, c + size_, color_.get());
-            const text *t = rhs.craw_text().get();
-            std::copy(t, t + size_, text_.get());
-            const mask8bit *m = rhs.craw_mask8bit().get();
-            std::copy(m, m + size_of_mask8bit_, mask8bit_.get());
+        text_image(const text_image_view<int_type, uint_type> &view) :
+            w_(validator_if_less_than<uint_type, 1>(view.width())), h_(validator_if_less_than<uint_type, 1>(view.height())), size_(w_ * h_),
+            color_(std::make_unique<color[]>(size_)),
+            text_(std::make_unique<text[]>(size_)),
+            size_of_mask8bit_(size_ % 8 == 0 ? size_ / 8 : size_ / 8 + 1),
+            mask8bit_(std::make_unique<mask8bit[]>(size_of_mask8bit_)) {
+            for (uint_type row = 0; row < h_; ++row) {
+                uint_type i = row * view.stride();
+                std::memcpy(&text_[row * w_], view.text_ptr() + i, sizeof(text) * w_);
+                std::memcpy(&color_[row * w_], view.color_ptr() + i, sizeof(color) * w_);
+                copy_mask_bits(mask8bit_.get(), row * w_, view.mask8bit_ptr(), view.mask_offset() + i, w_);
+            }
+        }
+
+        // An empty rhs, e.g. default constructed, gives an empty
+        // image, which the view constructor would refuse
+
+        text_image(const text_image &rhs) {
+            if (rhs.size_ > 0 && rhs.color_) *this = text_image(rhs.view());
         }
 
         text_image(text_image &&rhs) :
@@ -140,17 +313,26 @@ namespace g80 {
         }
 
         auto operator=(const text_image &rhs) -> text_image & {
-            if (this != &rhs) {
+            if (this != &rhs && (rhs.size_ == 0 || !rhs.color_)) {
+                w_ = h_ = size_ = size_of_mask8bit_ = 0;
+                color_.reset();
+                text_.reset();
+                mask8bit_.reset();
+            } else if (this != &rhs) {
+
+                // Buffers of the same size are reused
+                if (!color_ || size_ != rhs.size_) {
+                    color_.reset(new color[rhs.size_]);
+                    text_.reset(new text[rhs.size_]);
+                    mask8bit_.reset(new mask8bit[rhs.size_of_mask8bit_]);
+                }
                 w_ = {rhs.w_};
                 h_ = {rhs.h_};
                 size_ = {rhs.size_};
                 size_of_mask8bit_ = (rhs.size_of_mask8bit_);
-                color_.reset(new color[size_]);
                 std::copy(rhs.color_.get(), rhs.color_.get() + size_, color_.get());
-                text_.reset(new text[size_]);
                 std::copy(rhs.text_.get(), rhs.text_.get() + size_, text_.get());
-                mask8bit_.reset(new mask8bit[size_of_mask8bit_]);
-                std::copy(rhs.mask8bit_.get(), rhs.mask8bit_.get() + size_, mask8bit_.get());
+                std::copy(rhs.mask8bit_.get(), rhs.mask8bit_.get() + size_of_mask8bit_, mask8bit_.get());
             }
             return *this;
         }
@@ -161,11 +343,11 @@ namespace g80 {
                 h_ = {rhs.h_};
                 size_ = {rhs.size_};
                 size_of_mask8bit_ = (rhs.size_of_mask8bit_);
-                color_.reset(rhs.raw_color().get());
+                color_.reset(rhs.raw_color_ptr().get());
                 rhs.color_.release();
-                text_.reset(rhs.raw_text().get());
+                text_.reset(rhs.raw_text_ptr().get());
                 rhs.text_.release();
-                mask8bit_.reset(rhs.raw_mask8bit().get());
+                mask8bit_.reset(rhs.raw_mask8bit_ptr().get());
                 rhs.mask8bit_.release();
             }
             return *this;
@@ -217,59 +399,74 @@ namespace g80 {
         }
 
     // Debuggers
+    private:
+
+        // A single output buffer reused by all show*()
+        // so a steady-state frame allocates nothing
+
+        static auto show_output(const std::size_t capacity) -> text_output & {
+            static text_output output;
+            output.clear();
+            output.reserve(capacity);
+            return output;
+        }
+
     public:
 
         auto show_color() const -> void {
-            std::stringstream output;
+            text_output &output = show_output(esc_clear_screen.size + esc_reset_attrib.size + 1 + size_ * 3 + h_);
             
-            output << "\033[2J";
+            output.append(esc_clear_screen);
             uint_type next_line = w_;
             for (uint_type i = 0; i < size_; ++i) {
-                if (i == next_line) {output << "\n"; next_line += w_;} 
-                output << std::setw(3) << std::hex << static_cast<int>(color_[i]);
+                if (i == next_line) {output.push_back('\n'); next_line += w_;} 
+                output.append_uint(color_[i], 3, 16);
             }
 
-            output << "\033[0m\n";
-            std::cout << output.str();              
+            output.append(esc_reset_attrib);
+            output.push_back('\n');
+            output.flush();
         }
 
         auto show_text() const -> void {
-            std::stringstream output;
+            text_output &output = show_output(esc_clear_screen.size + esc_reset_attrib.size + 1 + size_ + h_);
             
-            output << "\033[2J";
+            output.append(esc_clear_screen);
             uint_type next_line = w_;
             for (uint_type i = 0; i < size_; ++i) {
-                if (i == next_line) {output << "\n"; next_line += w_;} 
-                output << text_[i];
+                if (i == next_line) {output.push_back('\n'); next_line += w_;} 
+                output.push_back(static_cast<char>(text_[i]));
             }
 
-            output << "\033[0m\n";
-            std::cout << output.str();              
+            output.append(esc_reset_attrib);
+            output.push_back('\n');
+            output.flush();
         }
 
         auto show_mask(int_type marker) const -> void {
-            std::stringstream output;
+            text_output &output = show_output(w_ + 1 + size_ + h_ + esc_reset_attrib.size + 2);
             
             mask8bit mask = 0x01;
 
             // Draw header label
-            for (int_type i = 0; i < w_; ++i) output << i % 10;
-            output << "\n";
+            for (int_type i = 0; i < w_; ++i) output.push_back(static_cast<char>('0' + i % 10));
+            output.push_back('\n');
             
             // Draw bits
             uint_type next_line = w_;
             for (uint_type i = 0; i < size_; ++i) {
-                if (i == next_line) {output << "\n"; next_line += w_;} 
+                if (i == next_line) {output.push_back('\n'); next_line += w_;} 
                 
-                if (i == marker) output << "_";
-                else output << ((mask8bit_[i / 8] & mask) ? "1" : ".");
+                if (i == marker) output.push_back('_');
+                else output.push_back((mask8bit_[i / 8] & mask) ? '1' : '.');
                 
                 mask <<= 1;
                 if (!mask) mask = 0x01;
             }
 
-            output << "\033[0m\n\n";
-            std::cout << output.str();
+            output.append(esc_reset_attrib);
+            output.append("\n\n", 2);
+            output.flush();
         }
 
         auto show_mask_value() const -> void {
@@ -380,14 +577,22 @@ namespace g80 {
             std::fill_n(&mask8bit_[0], size_of_mask8bit_, 0x00);           
         }
 
+    private:
+
+        auto create_mask_if(const uint8_t *plane, const uint8_t value) -> void {
+            uint_type i = 0;
+            for (; i + 8 <= size_; i += 8) mask8bit_[i / 8] = match_bytes_to_bits(&plane[i], value);
+            for (; i < size_; ++i) set_mask(i, plane[i] == value ? ON : OFF);
+        }
+
+    public:
+
         auto create_mask_if_color(const color c) -> void {
-            for (uint_type i = 0; i < size_; ++i) 
-                set_mask(i, color_[i] == c ? ON : OFF);
+            create_mask_if(color_.get(), c);
         }
 
         auto create_mask_if_text(const text &t) -> void {
-            for (uint_type i = 0; i < size_; ++i) 
-                set_mask(i, text_[i] == t ? ON : OFF);
+            create_mask_if(text_.get(), t);
         }
 
         auto invert_mask() -> void {
@@ -409,110 +614,128 @@ namespace g80 {
      * 
      */
 
-    private:
-        auto get_mask8bit_value(const uint_type ix, const uint_type size, const uint_type init_offset = 0) const -> mask8bit {
-            if (size == 0 || size > 8) return 0;
-
-            uint_type ix8 = ix / 8;
-            uint_type nix8 = (ix + size - 1) / 8;
-            uint_type offset = ix % 8 - init_offset;
-
-            mask8bit value;
-            if (offset >= 0) {
-                value = mask8bit_[ix8] >> offset;
-                value &= ~((1 << init_offset) - 1);
-                if (nix8 > ix8 && nix8 < size_of_mask8bit_)
-                    value |= mask8bit_[nix8] << (8 - offset);
-                value &= (1 << (size + init_offset)) - 1;
-            } else {
-                value = mask8bit_[ix8];
-                value = mask8bit_[ix8] << -offset;
-                value &= ~((1 << init_offset) - 1);
-                value &= (1 << (size + init_offset)) - 1;
-            } 
+    public:
 
-            return value;
+        inline auto view() const -> text_image_view<int_type, uint_type> {
+            return text_image_view<int_type, uint_type>(text_.get(), color_.get(), mask8bit_.get(), 0, w_, w_, h_);
         }
 
-    public:
+        // Returns a non-owning view of the region clipped
+        // against the image. Nothing is allocated or copied.
 
-        auto get_image(const int_type x, const int_type y, const uint_type w, const uint_type h) const -> text_image {
+        auto get_image_view(const int_type x, const int_type y, const uint_type w, const uint_type h) const -> text_image_view<int_type, uint_type> {
+            int64_t sx = x, sy = y;
+            int64_t ex = sx + w, ey = sy + h;
+            if (sx < 0) sx = 0;
+            if (sy < 0) sy = 0;
+            if (ex > static_cast<int64_t>(w_)) ex = w_;
+            if (ey > static_cast<int64_t>(h_)) ey = h_;
+            if (ex <= sx || ey <= sy) return text_image_view<int_type, uint_type>();
 
-            if (w == 0 || h == 0) return text_image();
+            uint_type start = static_cast<uint_type>(sy * w_ + sx);
+            return text_image_view<int_type, uint_type>(&text_[start], &color_[start], mask8bit_.get(), start, w_, 
+                static_cast<uint_type>(ex - sx), static_cast<uint_type>(ey - sy));
+        }
 
-            text_image dest_text_image(w, h, 7, ' ', OFF);
-            text *text_ptr = dest_text_image.raw_text_ptr().get();
-            color *color_ptr = dest_text_image.raw_color_ptr().get();
+        auto get_image(const int_type x, const int_type y, const uint_type w, const uint_type h) const -> text_image {
+            text_image_view<int_type, uint_type> view = get_image_view(x, y, w, h);
+            if (view.empty()) return text_image();
+            return text_image(view);
+        }
 
-            uint_type start = ix(x, y);
-            for (uint_type row = 0; row < h; ++row) {
-                uint_type i = (start + row * w_) % size_;
-                memcpy(text_ptr, &text_[i], sizeof(text) * w);
-                memcpy(color_ptr, &color_[i], sizeof(color) * w);
-                text_ptr += w;
-                color_ptr += w;
-            }
+    private:
 
-            // Copy mask in chunks of 8-bits
-            // which is faster by a factor of 3 than 
-            // copying mask bit by bit
-
-            mask8bit *mask8bit_ptr = dest_text_image.raw_mask8bit_ptr().get();
-            uint_type total_copied = 0;
-            for (uint_type row = 0; row < h; ++row) {
-                uint_type ix = (start + row * w_) % size_;
-                uint_type size = w;
-                do {
-                    uint_type init_offset = total_copied % 8;
-                    uint_type s = 8 - total_copied % 8;
-                    s = s > size ? size : s;
-                    mask8bit mask = get_mask8bit_value(ix, s, init_offset);
-                    mask8bit_ptr[total_copied / 8] |= mask;
-                    total_copied += s;
-                    ix += s;
-                    size -= s;
-                } while(size > 0);
-            }
+        // Copies the part of timg that falls inside the canvas row by row.
+        // put_image copies whole row spans. The boolean blits combine both
+        // masks 64 cells at a time and select text and color by the result.
 
-            return dest_text_image;            
-        }
+        template<typename mask_op_type>
+        auto bit_image(const int_type x, const int_type y, const text_image_view<int_type, uint_type> &timg, const mask_op_type &mask_op, const bool is_put) -> void {
+            int64_t sx = 0, sy = 0;
+            int64_t dx = x, dy = y;
+            int64_t w = timg.width(), h = timg.height();
+            
+            if (dx < 0) {sx = -dx; w += dx; dx = 0;}
+            if (dy < 0) {sy = -dy; h += dy; dy = 0;}
+            if (dx + w > static_cast<int64_t>(w_)) w = static_cast<int64_t>(w_) - dx;
+            if (dy + h > static_cast<int64_t>(h_)) h = static_cast<int64_t>(h_) - dy;
+            if (w <= 0 || h <= 0) return;
+
+            for (int64_t r = 0; r < h; ++r) {
+                const std::size_t tix = static_cast<std::size_t>((dy + r) * w_ + dx);
+                const std::size_t six = static_cast<std::size_t>((sy + r) * timg.stride() + sx);
+                text *t = &text_[tix];
+                color *c = &color_[tix];
+                const text *st = timg.text_ptr() + six;
+                const color *sc = timg.color_ptr() + six;
+
+                if (is_put) {
+                    std::memcpy(t, st, sizeof(text) * w);
+                    std::memcpy(c, sc, sizeof(color) * w);
+                    continue;
+                }
 
-    private:
+                for (int64_t i = 0; i < w; i += 64) {
+                    const std::size_t n = static_cast<std::size_t>(w - i < 64 ? w - i : 64);
+                    const uint64_t all = n == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << n) - 1;
+                    const uint64_t bits = mask_op(get_mask_bits(mask8bit_.get(), tix + i, n), get_mask_bits(timg.mask8bit_ptr(), timg.mask_offset() + six + i, n)) & all;
+                    
+                    if (bits == 0) continue;
+                    if (bits == all) {
+                        std::memcpy(t + i, st + i, sizeof(text) * n);
+                        std::memcpy(c + i, sc + i, sizeof(color) * n);
+                        continue;
+                    }
 
-        auto bit_image(const int_type x, const int_type y, const text_image &timg, 
-        const std::function<auto (uint_type, uint_type, const text_image &) -> bool> &conditional) {
-            for (uint_type r = 0; r < timg.h_; ++r) {
-                uint_type tix = ix(x, y + r); 
-                for (uint_type six = timg.ix(0, r), sixm = six + timg.w_; six < sixm; ++six) {           
-                    if (conditional(tix, six, timg)) {
-                        set_text(tix, timg.craw_text_ptr().get()[six]);
-                        set_color(tix, timg.craw_color_ptr().get()[six]);
+                    // Blend 8 cells per 64-bit word using the
+                    // selected bits expanded into byte masks
+                    std::size_t k = 0;
+                    for (; k + 8 <= n; k += 8) {
+                        const uint64_t select = expand_bits_to_bytes[(bits >> k) & 0xff];
+                        blend_word(t + i + k, st + i + k, select);
+                        blend_word(c + i + k, sc + i + k, select);
+                    }
+                    for (; k < n; ++k) {
+                        const bool is_selected = (bits >> k) & 1;
+                        t[i + k] = is_selected ? st[i + k] : t[i + k];
+                        c[i + k] = is_selected ? sc[i + k] : c[i + k];
                     }
-                    ++tix;
                 }
-            }            
+            }
         }
 
     public:
 
+        auto put_image(const int_type x, const int_type y, const text_image_view<int_type, uint_type> &timg) -> void {
+            bit_image(x, y, timg, [](const uint64_t, const uint64_t) -> uint64_t {return 0;}, true);
+        }
+
+        auto and_image(const int_type x, const int_type y, const text_image_view<int_type, uint_type> &timg) -> void {
+            bit_image(x, y, timg, [](const uint64_t d, const uint64_t s) -> uint64_t {return d & s;}, false);
+        }
+
+        auto or_image(const int_type x, const int_type y, const text_image_view<int_type, uint_type> &timg) -> void {
+            bit_image(x, y, timg, [](const uint64_t d, const uint64_t s) -> uint64_t {return d | s;}, false);
+        }
+
+        auto xor_image(const int_type x, const int_type y, const text_image_view<int_type, uint_type> &timg) -> void {
+            bit_image(x, y, timg, [](const uint64_t d, const uint64_t s) -> uint64_t {return d ^ s;}, false);
+        }
+
         auto put_image(const int_type x, const int_type y, const text_image &timg) -> void {
-            static const auto conditional = [&](uint_type, uint_type, const text_image &) -> bool {return true;};
-            bit_image(x, y, timg, conditional);
+            put_image(x, y, timg.view());
         }
 
         auto and_image(const int_type x, const int_type y, const text_image &timg) -> void {
-            static const auto conditional = [&](uint_type tix, uint_type six, const text_image &timg) -> bool {return (get_mask(tix) & timg.get_mask(six)) == ON;};
-            bit_image(x, y, timg, conditional);
+            and_image(x, y, timg.view());
         }
 
         auto or_image(const int_type x, const int_type y, const text_image &timg) -> void {
-            static const auto conditional = [&](uint_type tix, uint_type six, const text_image &timg) -> bool {return (get_mask(tix) | timg.get_mask(six)) == ON;};
-            bit_image(x, y, timg, conditional);
+            or_image(x, y, timg.view());
         }
 
         auto xor_image(const int_type x, const int_type y, const text_image &timg) -> void {
-            static const auto conditional = [&](uint_type tix, uint_type six, const text_image &timg) -> bool {return (get_mask(tix) ^ timg.get_mask(six)) == ON;};
-            bit_image(x, y, timg, conditional);
+            xor_image(x, y, timg.view());
         }
 
 
@@ -526,18 +749,18 @@ namespace g80 {
             else if (shift == 0) return;
 
             if (tia & TEXT) {
-                for (uint_type i = 0; i < size_ - shift; ++i) set_text(i, text_[i + shift]);
-                for (uint_type i = size_ - shift; i < size_; ++i) set_text(i, default_text);
+                std::memmove(&text_[0], &text_[shift], sizeof(text) * (size_ - shift));
+                std::fill_n(&text_[size_ - shift], shift, default_text);
             }
 
             if (tia & COLOR) {
-                for (uint_type i = 0; i < size_ - shift; ++i) set_color(i, color_[i + shift]);
-                for (uint_type i = size_ - shift; i < size_; ++i) set_color(i, default_color);
+                std::memmove(&color_[0], &color_[shift], sizeof(color) * (size_ - shift));
+                std::fill_n(&color_[size_ - shift], shift, default_color);
             }
 
             if (tia & MASK) {
-                for (uint_type i = 0; i < size_ - shift; ++i) set_mask(i, get_mask(i + shift));
-                for (uint_type i = size_ - shift; i < size_; ++i) set_mask(i, default_mask_bit);      
+                move_mask_bits(mask8bit_.get(), 0, mask8bit_.get(), shift, size_ - shift);
+                fill_mask_bits(mask8bit_.get(), size_ - shift, shift, default_mask_bit);
             }            
         }
 
@@ -547,18 +770,18 @@ namespace g80 {
             else if (shift == 0) return;
 
             if (tia & TEXT) {
-                for (uint_type i = size_ - 1; i >= shift; --i) set_text(i, text_[i - shift]);
-                for (uint_type i = 0; i < shift; ++i) set_text(i, default_text);
+                std::memmove(&text_[shift], &text_[0], sizeof(text) * (size_ - shift));
+                std::fill_n(&text_[0], shift, default_text);
             }
 
             if (tia & COLOR) {
-                for (uint_type i = size_ - 1; i >= shift; --i) set_color(i, color_[i - shift]);
-                for (uint_type i = 0; i < shift; ++i) set_color(i, default_color);
+                std::memmove(&color_[shift], &color_[0], sizeof(color) * (size_ - shift));
+                std::fill_n(&color_[0], shift, default_color);
             }
 
             if (tia & MASK) {
-                for (uint_type i = size_ - 1; i >= shift; --i) set_mask(i, get_mask(i - shift));
-                for (uint_type i = 0; i < shift; ++i) set_mask(i, default_mask_bit);
+                move_mask_bits(mask8bit_.get(), shift, mask8bit_.get(), 0, size_ - shift);
+                fill_mask_bits(mask8bit_.get(), 0, shift, default_mask_bit);
             }
         }
 
@@ -573,34 +796,127 @@ namespace g80 {
                 while (i < j) std::swap(color_[i++], color_[j--]);
             }
 
+            // Swap up to 64 bits from both ends at a time,
+            // each chunk bit-reversed into its mirror position
             if (tia & MASK) {
-                uint_type i = start, j = end;
-                while (i < j) {
-                    mask_bit t = get_mask(i);
-                    set_mask(i, get_mask(j));
-                    set_mask(j, t);
-                    ++i;
-                    --j;
+                std::size_t i = start, n = end >= start ? end - start + 1 : 0;
+                while (n > 1) {
+                    const std::size_t k = n / 2 < 64 ? n / 2 : 64;
+                    const std::size_t j = i + n - k;
+                    const uint64_t lhs = get_mask_bits(mask8bit_.get(), i, k);
+                    const uint64_t rhs = get_mask_bits(mask8bit_.get(), j, k);
+                    set_mask_bits(mask8bit_.get(), i, k, reverse_bits(rhs) >> (64 - k));
+                    set_mask_bits(mask8bit_.get(), j, k, reverse_bits(lhs) >> (64 - k));
+                    i += k;
+                    n -= 2 * k;
                 }
             }            
         }
 
+    private:
+
+        auto scratch(const std::size_t size) -> uint8_t * {
+            if (size > size_of_scratch_) {
+                scratch_.reset(new uint8_t[size]);
+                size_of_scratch_ = size;
+            }
+            return scratch_.get();
+        }
+
+        // Rotates p[0..n) right by r (0 < r < n) with one memmove,
+        // parking the smaller of the two parts in the scratch area
+
+        auto rotate_bytes_right(uint8_t *p, const std::size_t n, const std::size_t r) -> void {
+            if (r <= n - r) {
+                uint8_t *s = scratch(r);
+                std::memcpy(s, p + n - r, r);
+                std::memmove(p + r, p, n - r);
+                std::memcpy(p, s, r);
+            } else {
+                const std::size_t l = n - r;
+                uint8_t *s = scratch(l);
+                std::memcpy(s, p, l);
+                std::memmove(p, p + l, r);
+                std::memcpy(p + r, s, l);
+            }
+        }
+
+        auto rotate_mask_right(const std::size_t start, const std::size_t n, const std::size_t r) -> void {
+            mask8bit *m = mask8bit_.get();
+            if (r <= n - r) {
+                uint8_t *s = scratch(r / 8 + 1);
+                copy_mask_bits(s, 0, m, start + n - r, r);
+                move_mask_bits(m, start + r, m, start, n - r);
+                copy_mask_bits(m, start, s, 0, r);
+            } else {
+                const std::size_t l = n - r;
+                uint8_t *s = scratch(l / 8 + 1);
+                copy_mask_bits(s, 0, m, start, l);
+                move_mask_bits(m, start, m, start + l, r);
+                copy_mask_bits(m, start + r, s, 0, l);
+            }
+        }
+
+        auto rotate_range_right(const uint_type start, const uint_type n, const uint_type r, const text_image_attrib tia) -> void {
+            if (r == 0 || r >= n) return;
+            if (tia & TEXT) rotate_bytes_right(&text_[start], n, r);
+            if (tia & COLOR) rotate_bytes_right(&color_[start], n, r);
+            if (tia & MASK) rotate_mask_right(start, n, r);
+        }
+
+        auto rotate_column_down(const uint_type x, const uint_type r, const text_image_attrib tia) -> void {
+            if (r == 0 || r >= h_ || x >= w_) return;
+            uint8_t *s = scratch(h_);
+            auto rotate_plane = [&](uint8_t *p) -> void {
+                for (uint_type y = 0; y < h_; ++y) s[y] = p[ix(x, y)];
+                for (uint_type y = 0; y < h_; ++y) p[ix(x, (y + r) % h_)] = s[y];
+            };
+            if (tia & TEXT) rotate_plane(text_.get());
+            if (tia & COLOR) rotate_plane(color_.get());
+            if (tia & MASK) {
+                for (uint_type y = 0; y < h_; ++y) s[y] = get_mask(ix(x, y));
+                for (uint_type y = 0; y < h_; ++y) set_mask(ix(x, (y + r) % h_), s[y] ? ON : OFF);
+            }
+        }
+
+    public:
+
         auto xlat_rotate_left(const uint_type rotate, const text_image_attrib tia) -> void {
             uint_type r = rotate >= size_ ? rotate % size_ : rotate;
-            if (r > 0) {
-                xlat_reverse(0, r - 1, tia);
-                xlat_reverse(r, size_ - 1, tia);
-                xlat_reverse(0, size_ - 1, tia);
-            }
+            if (r > 0) rotate_range_right(0, size_, size_ - r, tia);
         }
         
         auto xlat_rotate_right(const uint_type rotate, const text_image_attrib tia) -> void {
             uint_type r = rotate >= size_ ? rotate % size_ : rotate;
-            if (r > 0) {
-                xlat_reverse(0, size_ - 1, tia);
-                xlat_reverse(0, r - 1, tia);
-                xlat_reverse(r, size_ - 1, tia);
-            }            
+            if (r > 0) rotate_range_right(0, size_, r, tia);
+        }
+
+        auto xlat_rotate_row_left(const int_type y, const uint_type rotate, const text_image_attrib tia) -> void {
+            uint_type r = rotate >= w_ ? rotate % w_ : rotate;
+            if (r > 0 && y >= 0 && y < h_) rotate_range_right(ix(0, y), w_, w_ - r, tia);
+        }
+
+        auto xlat_rotate_row_right(const int_type y, const uint_type rotate, const text_image_attrib tia) -> void {
+            uint_type r = rotate >= w_ ? rotate % w_ : rotate;
+            if (r > 0 && y >= 0 && y < h_) rotate_range_right(ix(0, y), w_, r, tia);
+        }
+
+        auto xlat_rotate_rows_left(const uint_type rotate, const text_image_attrib tia) -> void {
+            for (uint_type y = 0; y < h_; ++y) xlat_rotate_row_left(y, rotate, tia);
+        }
+
+        auto xlat_rotate_rows_right(const uint_type rotate, const text_image_attrib tia) -> void {
+            for (uint_type y = 0; y < h_; ++y) xlat_rotate_row_right(y, rotate, tia);
+        }
+
+        auto xlat_rotate_column_up(const int_type x, const uint_type rotate, const text_image_attrib tia) -> void {
+            uint_type r = rotate >= h_ ? rotate % h_ : rotate;
+            if (r > 0 && x >= 0) rotate_column_down(x, h_ - r, tia);
+        }
+
+        auto xlat_rotate_column_down(const int_type x, const uint_type rotate, const text_image_attrib tia) -> void {
+            uint_type r = rotate >= h_ ? rotate % h_ : rotate;
+            if (r > 0 && x >= 0) rotate_column_down(x, r, tia);
         }
 
         auto xlat_flip_horizontal(const text_image_attrib tia) -> void {
@@ -641,11 +957,12 @@ namespace g80 {
                     uint_type kmax = k + w_;
                     uint_type l = ix(0, j--);
                     while (k < kmax) {
-                        mask_bit t = get_mask(l);
-                        set_mask(l, get_mask(k));
-                        set_mask(k, t);
-                        ++l;
-                        ++k; 
+                        const std::size_t n = kmax - k < 64 ? kmax - k : 64;
+                        const uint64_t t = get_mask_bits(mask8bit_.get(), l, n);
+                        set_mask_bits(mask8bit_.get(), l, n, get_mask_bits(mask8bit_.get(), k, n));
+                        set_mask_bits(mask8bit_.get(), k, n, t);
+                        l += n;
+                        k += n; 
                     }
                 }
             }            
@@ -667,7 +984,8 @@ namespace g80 {
 
     private:
 
-        auto gfx_line_loop(const int_type x1, const int_type y1, const int_type x2, const int_type y2,  const std::function<auto (const uint_type) -> void> &set_tia) -> void {
+        template<typename set_tia_type>
+        auto gfx_line_loop(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const set_tia_type &set_tia) -> void {
             int_type dx = x2 - x1;
             int_type dy = y2 - y1;
             int_type sdx = dx < 0 ? -1 : 1;
@@ -691,31 +1009,27 @@ namespace g80 {
     public:
 
         auto gfx_line_color(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const color c) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_color(i, c);};
-            gfx_line_loop(x1, y1, x2, y2, set_tia);
+            gfx_line_loop(x1, y1, x2, y2, [&](const uint_type i) -> void {set_color(i, c);});
         }
 
         auto gfx_line_text(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const text t) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_text(i, t);};
-            gfx_line_loop(x1, y1, x2, y2, set_tia);
+            gfx_line_loop(x1, y1, x2, y2, [&](const uint_type i) -> void {set_text(i, t);});
         }
 
         auto gfx_line_mask(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const mask_bit m) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_mask(i, m);};
-            gfx_line_loop(x1, y1, x2, y2, set_tia);
+            gfx_line_loop(x1, y1, x2, y2, [&](const uint_type i) -> void {set_mask(i, m);});
         }
 
         auto gfx_line(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const color c, const text t, const mask_bit m) -> void {
-            gfx_line_color(x1, y1, x2, y2, c);
-            gfx_line_text(x1, y1, x2, y2, t);
-            gfx_line_mask(x1, y1, x2, y2, m);
+            gfx_line_loop(x1, y1, x2, y2, [&](const uint_type i) -> void {set_color(i, c); set_text(i, t); set_mask(i, m);});
         }
 
     // Draw Circle using color, text or mask
 
     private:
 
-        auto gfx_circle_loop(const int_type cx, const int_type cy, const int_type r, const std::function<auto (const uint_type) -> void> &set_tia) -> void {
+        template<typename set_tia_type>
+        auto gfx_circle_loop(const int_type cx, const int_type cy, const int_type r, const set_tia_type &set_tia) -> void {
             
             uint_type center_point = ix(cx, cy);
 
@@ -756,31 +1070,27 @@ namespace g80 {
     public:
         
         auto gfx_circle_color(const int_type cx, const int_type cy, const int_type r, const color c) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_color(i, c);};
-            gfx_circle_loop(cx, cy, r, set_tia);
+            gfx_circle_loop(cx, cy, r, [&](const uint_type i) -> void {set_color(i, c);});
         }
         
         auto gfx_circle_text(const int_type cx, const int_type cy, const int_type r, const text t) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_text(i, t);};
-            gfx_circle_loop(cx, cy, r, set_tia);
+            gfx_circle_loop(cx, cy, r, [&](const uint_type i) -> void {set_text(i, t);});
         }
 
         auto gfx_circle_mask(const int_type cx, const int_type cy, const int_type r, const mask_bit m) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_mask(i, m);};
-            gfx_circle_loop(cx, cy, r, set_tia);
+            gfx_circle_loop(cx, cy, r, [&](const uint_type i) -> void {set_mask(i, m);});
         }
 
         auto gfx_circle(const int_type cx, const int_type cy, const int_type r, const color c, const text t, const mask_bit m) -> void {
-            gfx_circle_color(cx, cy, r, c);
-            gfx_circle_text(cx, cy, r, t);
-            gfx_circle_mask(cx, cy, r, m);
+            gfx_circle_loop(cx, cy, r, [&](const uint_type i) -> void {set_color(i, c); set_text(i, t); set_mask(i, m);});
         }
 
     // Draw Arc using color, text or mask
 
     private:
 
-        auto gfx_arc_loop(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const std::function<auto (const uint_type) -> void> &set_tia) -> void {
+        template<typename set_tia_type>
+        auto gfx_arc_loop(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const set_tia_type &set_tia) -> void {
             uint_type center_point = ix(cx, cy);
 
             int_type x = r;
@@ -804,73 +1114,55 @@ namespace g80 {
                 n_ea -= 360 * t;
             }
 
+            // An arc past 360 wraps into a second 
+            // pass from 0 to the remainder
             int_type extended_sa, extended_ea;
             if (n_ea > 360) {extended_sa = 0; extended_ea = n_ea % 360;} 
             else {extended_sa = -1; extended_ea = -1;}
 
-            struct octa_bound {int_type sx, ex, *xy, xy_mul, *bxy, bxy_mul, type; };
-            std::unordered_map<int_type, octa_bound> octa_bounds;
+            // At most one clipped x range per octant per pass
+            struct octa_bound {int_type sx, ex; uint8_t octant, type;};
+            std::array<octa_bound, 16> octa_bounds;
+            std::array<int8_t, 8> octant_bound_ix;
+            octant_bound_ix.fill(-1);
+            uint8_t size_of_octa_bounds = 0;
 
             int_type t_sa = n_sa;
             int_type t_ea = n_ea;
             for (int_type j = 0; j <= 8; j += 8) {
                 for (int_type i = j, a = 0; i < j + 8; ++i, a += 45) {
-                    octa_bound ob;
-                    
+                    int_type sd, ed;
+                    uint8_t type;
+
                     // 0: n_sa ----| a  ------ a45 | ------- n_ea 
-                    if (a >= t_sa && a + 45 <= t_ea) {
-                        ob.sx = static_cast<int_type>(cos(a * M_PI / 180) * r);
-                        ob.ex = static_cast<int_type>(cos((a + 45) * M_PI / 180) * r);
-                        ob.type = 0;
+                    if (a >= t_sa && a + 45 <= t_ea) {sd = a; ed = a + 45; type = 0;}
                     
                     // 1: a ----| n_sa  ------ n_ea | ------- a45 
-                    } else if (t_sa >= a && t_ea <= a + 45) {
-                        ob.sx = static_cast<int_type>(cos(t_sa * M_PI / 180) * r);
-                        ob.ex = static_cast<int_type>(cos(t_ea * M_PI / 180) * r);
-                        ob.type = 1;
+                    else if (t_sa >= a && t_ea <= a + 45) {sd = t_sa; ed = t_ea; type = 1;}
                     
                     // 2: a ----| n_sa  ------ a45 | ------- n_ea 
-                    } else if (t_sa >= a && t_sa <= a + 45) {
-                        ob.sx = static_cast<int_type>(cos(t_sa * M_PI / 180) * r);
-                        ob.ex = static_cast<int_type>(cos((a + 45) * M_PI / 180) * r);
-                        ob.type = 2;
+                    else if (t_sa >= a && t_sa <= a + 45) {sd = t_sa; ed = a + 45; type = 2;}
                     
                     // 3: n_sa ---- | a ---- n_ea  ------ | a45 
-                    } else if (t_ea > a && t_ea <= a + 45) {
-                        ob.sx = static_cast<int_type>(cos(a * M_PI / 180) * r);
-                        ob.ex = static_cast<int_type>(cos(t_ea * M_PI / 180) * r);
-                        ob.type = 3;
+                    else if (t_ea > a && t_ea <= a + 45) {sd = a; ed = t_ea; type = 3;}
                     
                     // Beyond scope of octant
+                    else continue;
+
+                    uint8_t octant = static_cast<uint8_t>(i % 8);
+                    int_type sx = static_cast<int_type>(cos(sd * M_PI / 180) * r);
+                    int_type ex = static_cast<int_type>(cos(ed * M_PI / 180) * r);
+                    if (octant < 4) std::swap(sx, ex);
+
+                    // A second range in an octant already drawn is only kept when
+                    // the first one was clipped (types 1 and 2), and ends the pass
+                    if (octant_bound_ix[octant] < 0) {
+                        octant_bound_ix[octant] = static_cast<int8_t>(size_of_octa_bounds);
+                        octa_bounds[size_of_octa_bounds++] = {sx, ex, octant, type};
                     } else {
-                        continue;
-                    }
-
-                    int_type ix = i % 8;
-                    if (ix < 4) {
-                        ob.bxy_mul = -1;
-                        std::swap(ob.sx, ob.ex);
-                    } else {
-                        ob.bxy_mul = +1;
-                    }
-
-                    if (ix == 0 || ix == 1 || ix == 6 || ix == 7) ob.xy_mul = +1;
-                    else ob.xy_mul = -1;
-
-                    if (ix == 0 || ix == 3 || ix == 4 || ix == 7) {
-                        ob.xy = &x;
-                        ob.bxy = &by;
-                    } else {
-                        ob.xy = &y;
-                        ob.bxy = &bx;
-                    }
-
-                    auto f = octa_bounds.find(ix);
-                    if (f == octa_bounds.end()) {
-                        octa_bounds.insert({ix, ob});
-                    } else {
-                        if (f->second.type == 1 || f->second.type == 2) {
-                            octa_bounds.insert({i, ob});
+                        uint8_t prev_type = octa_bounds[octant_bound_ix[octant]].type;
+                        if (prev_type == 1 || prev_type == 2) {
+                            octa_bounds[size_of_octa_bounds++] = {sx, ex, octant, type};
                             break;
                         }
                     }
@@ -881,17 +1173,15 @@ namespace g80 {
                 t_ea = extended_ea;
             }
 
-            auto draw_arc = [&](const octa_bound &ob) -> void { 
-                if (*ob.xy * ob.xy_mul >= ob.sx && 
-                    *ob.xy * ob.xy_mul <= ob.ex) {
-                    uint_type i = center_point + (*ob.xy * ob.xy_mul) + (*ob.bxy * ob.bxy_mul);
-                    set_tia(i);
-                }
-            };
-
             while (x >= y)
             {
-                for (auto &o : octa_bounds) draw_arc(o.second);
+                for (uint8_t k = 0; k < size_of_octa_bounds; ++k) {
+                    const octa_bound &ob = octa_bounds[k];
+                    const arc_octant &o = arc_octants[ob.octant];
+                    int_type v = (o.is_x ? x : y) * o.xy_mul;
+                    if (v >= ob.sx && v <= ob.ex) 
+                        set_tia(center_point + v + (o.is_x ? by : bx) * o.bxy_mul);
+                }
 
                 ++y;
                 re += dy;
@@ -910,75 +1200,283 @@ namespace g80 {
     public:
 
         auto gfx_arc_color(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const color c) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_color(i, c);};
-            gfx_arc_loop(cx, cy, r, sa, ea, set_tia);
+            gfx_arc_loop(cx, cy, r, sa, ea, [&](const uint_type i) -> void {set_color(i, c);});
         }
         
         auto gfx_arc_text(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const text t) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_text(i, t);};
-            gfx_arc_loop(cx, cy, r, sa, ea, set_tia);
+            gfx_arc_loop(cx, cy, r, sa, ea, [&](const uint_type i) -> void {set_text(i, t);});
         }
 
         auto gfx_arc_mask(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const mask_bit m) -> void {
-            const std::function<auto (const int_type) -> void> set_tia = [&](const uint_type i) -> void {set_mask(i, m);};
-            gfx_arc_loop(cx, cy, r, sa, ea, set_tia);
+            gfx_arc_loop(cx, cy, r, sa, ea, [&](const uint_type i) -> void {set_mask(i, m);});
         }
 
         auto gfx_arc(const int_type cx, const int_type cy, const int_type r, const int_type sa, const int_type ea, const color c, const text t, const mask_bit m) -> void {
-            gfx_arc_color(cx, cy, r, sa, ea, c);
-            gfx_arc_text(cx, cy, r, sa, ea, t);
-            gfx_arc_mask(cx, cy, r, sa, ea, m);
+            gfx_arc_loop(cx, cy, r, sa, ea, [&](const uint_type i) -> void {set_color(i, c); set_text(i, t); set_mask(i, m);});
         }
     
     // Fill an area using color, text or mask
 
     private:
 
-        auto gfx_fill_loop(const int_type sx, const int_type sy, const std::function<auto (const uint_type) -> void> &set_tia, const std::function<auto (const uint_type) -> bool> &is_border) -> void {
-            std::vector<std::tuple<int_type, int_type>> points(size_);
-            int_type si = -1;
-            if (!is_border(ix(sx, sy))) points[++si] = {sx, sy};
-            while (si >= 0) {
-                auto [x, y] = points[si--];
-                uint_type i = ix(x, y);
-                set_tia(i);
-                if (y - 1 >= 0 && !is_border(ix(x, y - 1))) points[++si] = {x, y - 1};
-                if (y + 1 < h_ && !is_border(ix(x, y + 1))) points[++si] = {x, y + 1};
-                if (x - 1 >= 0 && !is_border(ix(x - 1, y))) points[++si] = {x - 1, y};
-                if (x + 1 < w_ && !is_border(ix(x + 1, y))) points[++si] = {x + 1, y};
+        // Scanline fill: each popped seed is grown into the widest run of
+        // non-border cells on its row, written with one span write, and the
+        // runs above and below it are pushed as seeds. The seed stack is
+        // kept in the image and reused across calls.
+
+        template<typename set_tia_span_type, typename is_border_type>
+        auto gfx_fill_loop(const int_type sx, const int_type sy, const set_tia_span_type &set_tia_span, const is_border_type &is_border) -> void {
+            if (sx < 0 || sy < 0 || sx >= w_ || sy >= h_) return;
+
+            auto push_runs = [&](const uint_type row, uint_type lx, const uint_type rx) -> void {
+                uint_type i = ix(lx, row);
+                while (lx <= rx) {
+                    while (lx <= rx && is_border(i)) {++lx; ++i;}
+                    if (lx > rx) break;
+                    fill_stack_.push_back(i);
+                    while (lx <= rx && !is_border(i)) {++lx; ++i;}
+                }
+            };
+
+            fill_stack_.clear();
+            fill_stack_.push_back(ix(sx, sy));
+            while (!fill_stack_.empty()) {
+                uint_type i = fill_stack_.back();
+                fill_stack_.pop_back();
+                if (is_border(i)) continue;
+
+                uint_type y = i / w_;
+                uint_type x = i % w_;
+                uint_type lx = x, rx = x;
+                while (lx > 0 && !is_border(i - (x - lx) - 1)) --lx;
+                while (rx + 1 < w_ && !is_border(i + (rx - x) + 1)) ++rx;
+
+                set_tia_span(ix(lx, y), rx - lx + 1);
+                if (y > 0) push_runs(y - 1, lx, rx);
+                if (y + 1 < h_) push_runs(y + 1, lx, rx);
             }
         }
     
     public:
 
         auto gfx_fill_color(const int_type x, const int_type y, const color c) -> void {
-            const std::function<auto (const uint_type) -> void> set_tia = [&](const uint_type i) -> void {set_color(i, c);};
-            const std::function<auto (const uint_type) -> bool> is_border = [&](const uint_type i) -> bool {if (i >= size_) return true; return color_[i] == c;};
-            gfx_fill_loop(x, y, set_tia, is_border);
+            const auto set_tia_span = [&](const uint_type i, const uint_type n) -> void {std::fill_n(&color_[i], n, c);};
+            const auto is_border = [&](const uint_type i) -> bool {return color_[i] == c;};
+            gfx_fill_loop(x, y, set_tia_span, is_border);
         }
 
         auto gfx_fill_text(const int_type x, const int_type y, const text t) -> void {
-            const std::function<auto (const uint_type) -> void> set_tia = [&](const uint_type i) -> void {set_text(i, t);};
-            const std::function<auto (const uint_type) -> bool> is_border = [&](const uint_type i) -> bool {if (i >= size_) return true; return text_[i] == t;};
-            gfx_fill_loop(x, y, set_tia, is_border);
+            const auto set_tia_span = [&](const uint_type i, const uint_type n) -> void {std::fill_n(&text_[i], n, t);};
+            const auto is_border = [&](const uint_type i) -> bool {return text_[i] == t;};
+            gfx_fill_loop(x, y, set_tia_span, is_border);
         }
 
         auto gfx_fill_mask(const int_type x, const int_type y, const mask_bit m) -> void {
-            const std::function<auto (const uint_type) -> void> set_tia = [&](const uint_type i) -> void {set_mask(i, m);};
-            const std::function<auto (const uint_type) -> bool> is_border = [&](const uint_type i) -> bool {if (i >= size_) return true; return get_mask(i) == m;};
-            gfx_fill_loop(x, y, set_tia, is_border);
+            const auto set_tia_span = [&](const uint_type i, const uint_type n) -> void {fill_mask_bits(mask8bit_.get(), i, n, m);};
+            const auto is_border = [&](const uint_type i) -> bool {return get_mask(i) == m;};
+            gfx_fill_loop(x, y, set_tia_span, is_border);
         }
 
         auto gfx_fill_with_text_border(const int_type x, const int_type y, const color c, const text t, const mask_bit m) -> void {
-            const std::function<auto (const uint_type) -> void> set_tia = [&](const uint_type i) -> void {
-                {
-                    set_color(i, c);
-                    set_text(i, t);
-                    set_mask(i, m);
-                }
+            const auto set_tia_span = [&](const uint_type i, const uint_type n) -> void {
+                std::fill_n(&color_[i], n, c);
+                std::fill_n(&text_[i], n, t);
+                fill_mask_bits(mask8bit_.get(), i, n, m);
             };
-            const std::function<auto (const uint_type) -> bool> is_border = [&](const uint_type i) -> bool {if (i >= size_) return true; return text_[i] == t;};
-            gfx_fill_loop(x, y, set_tia, is_border);
+            const auto is_border = [&](const uint_type i) -> bool {return text_[i] == t;};
+            gfx_fill_loop(x, y, set_tia_span, is_border);
+        }
+
+    // Filled shapes drawn as horizontal spans
+
+    private:
+
+        auto span_color(const color c) {
+            return [this, c](const uint_type i, const uint_type n) -> void {std::fill_n(&color_[i], n, c);};
+        }
+
+        auto span_text(const text t) {
+            return [this, t](const uint_type i, const uint_type n) -> void {std::fill_n(&text_[i], n, t);};
+        }
+
+        auto span_mask(const mask_bit m) {
+            return [this, m](const uint_type i, const uint_type n) -> void {fill_mask_bits(mask8bit_.get(), i, n, m);};
+        }
+
+        auto span_all(const color c, const text t, const mask_bit m) {
+            return [this, c, t, m](const uint_type i, const uint_type n) -> void {
+                std::fill_n(&color_[i], n, c);
+                std::fill_n(&text_[i], n, t);
+                fill_mask_bits(mask8bit_.get(), i, n, m);
+            };
+        }
+
+        // Clips the span x1..x2 (inclusive) on row y against the canvas
+        template<typename set_tia_span_type>
+        auto gfx_span(int64_t x1, int64_t x2, const int64_t y, const set_tia_span_type &set_tia_span) -> void {
+            if (y < 0 || y >= static_cast<int64_t>(h_)) return;
+            if (x1 > x2) std::swap(x1, x2);
+            if (x1 < 0) x1 = 0;
+            if (x2 >= static_cast<int64_t>(w_)) x2 = static_cast<int64_t>(w_) - 1;
+            if (x1 > x2) return;
+            set_tia_span(static_cast<uint_type>(y * w_ + x1), static_cast<uint_type>(x2 - x1 + 1));
+        }
+
+        template<typename set_tia_span_type>
+        auto gfx_rect_fill_loop(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const set_tia_span_type &set_tia_span) -> void {
+            int64_t sy = y1 < y2 ? y1 : y2;
+            int64_t ey = y1 < y2 ? y2 : y1;
+            for (int64_t y = sy; y <= ey; ++y) gfx_span(x1, x2, y, set_tia_span);
+        }
+
+        // Same midpoint steps as gfx_circle_loop, so the disc
+        // covers exactly the outline and everything inside it
+
+        template<typename set_tia_span_type>
+        auto gfx_circle_fill_loop(const int_type cx, const int_type cy, const int_type r, const set_tia_span_type &set_tia_span) -> void {
+            int64_t x = r;
+            int64_t y = 0;
+            int64_t dx = 1 - (static_cast<int64_t>(r) << 1);
+            int64_t dy = 1;
+            int64_t re = 0;
+
+            while (x >= y) {
+                gfx_span(cx - x, cx + x, cy - y, set_tia_span);
+                gfx_span(cx - x, cx + x, cy + y, set_tia_span);
+                gfx_span(cx - y, cx + y, cy - x, set_tia_span);
+                gfx_span(cx - y, cx + y, cy + x, set_tia_span);
+
+                ++y;
+                re += dy;
+                dy += 2;
+                if ((re << 1) + dx > 0) {
+                    --x;
+                    re += dx;
+                    dx += 2;
+                }
+            }
+        }
+
+        // Each row spans the widest x with (x/rx)^2 + (y/ry)^2 <= 1 
+
+        template<typename set_tia_span_type>
+        auto gfx_ellipse_fill_loop(const int_type cx, const int_type cy, const int_type rx, const int_type ry, const set_tia_span_type &set_tia_span) -> void {
+            const int64_t a = rx < 0 ? -rx : rx;
+            const int64_t b = ry < 0 ? -ry : ry;
+            if (b == 0) {gfx_span(cx - a, cx + a, cy, set_tia_span); return;}
+
+            const int64_t aa = a * a, bb = b * b;
+            for (int64_t y = 0; y <= b; ++y) {
+                const int64_t limit = aa * bb - y * y * aa;
+                int64_t x = static_cast<int64_t>(std::sqrt(static_cast<double>(limit) / bb));
+                while (x > 0 && x * x * bb > limit) --x;
+                while ((x + 1) * (x + 1) * bb <= limit) ++x;
+                gfx_span(cx - x, cx + x, cy - y, set_tia_span);
+                if (y > 0) gfx_span(cx - x, cx + x, cy + y, set_tia_span);
+            }
+        }
+
+        // Even-odd scanline fill. Edges cover the rows y0 <= y < y1
+        // so shared vertices are counted once, except on the last 
+        // row where y0 < y <= y1 keeps the bottom edge inclusive.
+
+        template<typename set_tia_span_type>
+        auto gfx_polygon_fill_loop(const std::vector<std::tuple<int_type, int_type>> &points, const set_tia_span_type &set_tia_span) -> void {
+            const std::size_t n = points.size();
+            if (n == 0) return;
+
+            int64_t sy = std::get<1>(points[0]), ey = sy;
+            for (auto &[px, py] : points) {
+                if (py < sy) sy = py;
+                if (py > ey) ey = py;
+            }
+            if (sy < 0) sy = 0;
+            if (ey >= static_cast<int64_t>(h_)) ey = static_cast<int64_t>(h_) - 1;
+
+            std::vector<double> &xs = polygon_xs_;
+            xs.reserve(n);
+            for (int64_t y = sy; y <= ey; ++y) {
+                xs.clear();
+                const bool is_last_row = y == ey;
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto [x0, y0] = points[i];
+                    auto [x1, y1] = points[(i + 1) % n];
+                    if (y0 == y1) continue;
+                    if (y0 > y1) {std::swap(x0, x1); std::swap(y0, y1);}
+                    if (is_last_row ? (y0 < y && y <= y1) : (y0 <= y && y < y1))
+                        xs.push_back(x0 + static_cast<double>(y - y0) * (x1 - x0) / (y1 - y0));
+                }
+
+                std::sort(xs.begin(), xs.end());
+                for (std::size_t i = 0; i + 1 < xs.size(); i += 2)
+                    gfx_span(std::lround(xs[i]), std::lround(xs[i + 1]), y, set_tia_span);
+            }
+        }
+
+    public:
+
+        auto gfx_rect_fill_color(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const color c) -> void {
+            gfx_rect_fill_loop(x1, y1, x2, y2, span_color(c));
+        }
+
+        auto gfx_rect_fill_text(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const text t) -> void {
+            gfx_rect_fill_loop(x1, y1, x2, y2, span_text(t));
+        }
+
+        auto gfx_rect_fill_mask(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const mask_bit m) -> void {
+            gfx_rect_fill_loop(x1, y1, x2, y2, span_mask(m));
+        }
+
+        auto gfx_rect_fill(const int_type x1, const int_type y1, const int_type x2, const int_type y2, const color c, const text t, const mask_bit m) -> void {
+            gfx_rect_fill_loop(x1, y1, x2, y2, span_all(c, t, m));
+        }
+
+        auto gfx_circle_fill_color(const int_type cx, const int_type cy, const int_type r, const color c) -> void {
+            gfx_circle_fill_loop(cx, cy, r, span_color(c));
+        }
+
+        auto gfx_circle_fill_text(const int_type cx, const int_type cy, const int_type r, const text t) -> void {
+            gfx_circle_fill_loop(cx, cy, r, span_text(t));
+        }
+
+        auto gfx_circle_fill_mask(const int_type cx, const int_type cy, const int_type r, const mask_bit m) -> void {
+            gfx_circle_fill_loop(cx, cy, r, span_mask(m));
+        }
+
+        auto gfx_circle_fill(const int_type cx, const int_type cy, const int_type r, const color c, const text t, const mask_bit m) -> void {
+            gfx_circle_fill_loop(cx, cy, r, span_all(c, t, m));
+        }
+
+        auto gfx_ellipse_fill_color(const int_type cx, const int_type cy, const int_type rx, const int_type ry, const color c) -> void {
+            gfx_ellipse_fill_loop(cx, cy, rx, ry, span_color(c));
+        }
+
+        auto gfx_ellipse_fill_text(const int_type cx, const int_type cy, const int_type rx, const int_type ry, const text t) -> void {
+            gfx_ellipse_fill_loop(cx, cy, rx, ry, span_text(t));
+        }
+
+        auto gfx_ellipse_fill_mask(const int_type cx, const int_type cy, const int_type rx, const int_type ry, const mask_bit m) -> void {
+            gfx_ellipse_fill_loop(cx, cy, rx, ry, span_mask(m));
+        }
+
+        auto gfx_ellipse_fill(const int_type cx, const int_type cy, const int_type rx, const int_type ry, const color c, const text t, const mask_bit m) -> void {
+            gfx_ellipse_fill_loop(cx, cy, rx, ry, span_all(c, t, m));
+        }
+
+        auto gfx_polygon_fill_color(const std::vector<std::tuple<int_type, int_type>> &points, const color c) -> void {
+            gfx_polygon_fill_loop(points, span_color(c));
+        }
+
+        auto gfx_polygon_fill_text(const std::vector<std::tuple<int_type, int_type>> &points, const text t) -> void {
+            gfx_polygon_fill_loop(points, span_text(t));
+        }
+
+        auto gfx_polygon_fill_mask(const std::vector<std::tuple<int_type, int_type>> &points, const mask_bit m) -> void {
+            gfx_polygon_fill_loop(points, span_mask(m));
+        }
+
+        auto gfx_polygon_fill(const std::vector<std::tuple<int_type, int_type>> &points, const color c, const text t, const mask_bit m) -> void {
+            gfx_polygon_fill_loop(points, span_all(c, t, m));
         }
 
     /**
@@ -992,47 +1490,184 @@ namespace g80 {
             return static_cast<uint_type>(y * w_ + x);
         }
 
-        auto save(const std::string &filename) const -> void {
+        auto save(const std::string &filename, const text_image_encoding encoding = ENCODE_RLE) const -> void {
             std::ofstream file (filename, std::ios::binary);
             file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-            file.write(static_cast<const char *>(static_cast<const void*>(&w_)), sizeof(w_));
-            file.write(static_cast<const char *>(static_cast<const void*>(&h_)), sizeof(h_));
-            file.write(static_cast<const char *>(static_cast<const void*>(color_.get())), size_);
-            file.write(static_cast<const char *>(static_cast<const void*>(text_.get())), size_);
-            file.write(static_cast<const char *>(static_cast<const void*>(mask8bit_.get())), size_of_mask8bit_);
+            save(file, encoding);
+        }
+
+        // Writes to or reads from the current position of a binary
+        // stream, so that images can follow one another. See
+        // text_image_codec.hpp for the format
+
+        auto save(std::ostream &file, const text_image_encoding encoding = ENCODE_RLE) const -> void {
+            std::vector<char> out;
+            out.reserve(32 + (2 * static_cast<std::size_t>(size_) + size_of_mask8bit_) * 129 / 128);
+
+            bool is_raw = encoding == ENCODE_RAW;
+            bool is_color_4bit = !is_raw && std::all_of(color_.get(), color_.get() + size_, [](const color c) {return c < 16;});
+
+            out.insert(out.end(), text_image_magic, text_image_magic + 4);
+            out.push_back(static_cast<char>(text_image_version));
+            out.push_back(static_cast<char>((is_color_4bit ? FORMAT_COLOR_4BIT : 0) | (is_raw ? FORMAT_RAW : 0)));
+            out.push_back(0);
+            out.push_back(0);
+            append_le32(out, w_);
+            append_le32(out, h_);
+
+            auto append_plane = [&](const uint8_t *data, const std::size_t n) {
+                std::size_t at = out.size();
+                append_le32(out, 0);
+                if (is_raw) out.insert(out.end(), data, data + n);
+                else rle_encode(data, n, out);
+                patch_le32(out, at, static_cast<uint32_t>(out.size() - at - 4));
+            };
+
+            if (is_color_4bit) {
+                std::vector<uint8_t> packed((static_cast<std::size_t>(size_) + 1) / 2, 0);
+                for (uint_type i = 0; i < size_; ++i) packed[i / 2] |= color_[i] << (4 * (i % 2));
+                append_plane(packed.data(), packed.size());
+            } else {
+                append_plane(color_.get(), size_);
+            }
+            append_plane(text_.get(), size_);
+            append_plane(mask8bit_.get(), size_of_mask8bit_);
+
+            crc32 crc;
+            crc.update(out.data(), out.size());
+            append_le32(out, crc.value());
+
+            file.write(out.data(), static_cast<std::streamsize>(out.size()));
         }
 
+        // Only badbit throws, so that truncated and corrupt files
+        // report the codec's errors as the stream overload does
+
         auto load(const std::string &filename) -> void {
             std::ifstream file (filename, std::ios::binary);
-            file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-            file.read(static_cast<char *>(static_cast<void *>(&w_)), sizeof(w_));
-            file.read(static_cast<char *>(static_cast<void *>(&h_)), sizeof(h_));
-            size_ = validator_if_less_than<uint_type, 1>(w_) * validator_if_less_than<uint_type, 1>(h_);
-            size_of_mask8bit_ = size_ % 8 == 0 ? size_ / 8 : size_ / 8 + 1;
-            color_.reset(new color[size_]);
-            file.read(static_cast<char *>(static_cast<void *>(color_.get())), size_);
-            text_.reset(new text[size_]);            
-            file.read(static_cast<char *>(static_cast<void *>(text_.get())), size_);
-            mask8bit_.reset(new mask8bit[size_of_mask8bit_]);           
-            file.read(static_cast<char *>(static_cast<void *>(mask8bit_.get())), size_of_mask8bit_);
+            if (!file) throw std::runtime_error(std::string("Unable to open ") + filename + ".");
+            file.exceptions (std::ifstream::badbit);
+            load(file);
         }
-        
+
+        // Also reads the unversioned format of earlier releases: native
+        // w and h of sizeof(uint_type), then the raw planes
+
+        auto load(std::istream &file) -> void {
+            crc32 crc;
+            uint8_t header[16];
+            read_exact(file, header, 4, crc);
+            if (std::memcmp(header, text_image_magic, 4) != 0) {
+                load_unversioned(file, header);
+                return;
+            }
+
+            read_exact(file, header + 4, 12, crc);
+            if (header[4] != text_image_version) throw std::runtime_error(std::string("Unsupported text_image version."));
+            bool is_color_4bit = header[5] & FORMAT_COLOR_4BIT;
+            bool is_raw = header[5] & FORMAT_RAW;
+
+            uint32_t w = get_le32(header + 8), h = get_le32(header + 12);
+            uint64_t size = static_cast<uint64_t>(w) * h;
+            if (w < 1 || h < 1 || size > static_cast<uint64_t>(static_cast<uint_type>(~static_cast<uint_type>(0))))
+                throw std::runtime_error(std::string("Invalid parameter."));
+
+            resize(static_cast<uint_type>(w), static_cast<uint_type>(h));
+
+            // The planes are decoded straight into the image, the
+            // packed colors into its front half then spread in place
+            auto load_plane = [&](uint8_t *to, const std::size_t n) {
+                uint8_t length[4];
+                read_exact(file, length, 4, crc);
+                if (!is_raw) {
+                    rle_decode(file, to, n, get_le32(length), crc);
+                } else {
+                    if (get_le32(length) != n) throw std::runtime_error(std::string("Corrupt text_image file."));
+                    read_exact(file, to, n, crc);
+                }
+            };
+
+            if (is_color_4bit) {
+                load_plane(color_.get(), (static_cast<std::size_t>(size_) + 1) / 2);
+                for (std::size_t i = size_; i-- > 0;) color_[i] = (color_[i / 2] >> (4 * (i % 2))) & 0x0f;
+            } else {
+                load_plane(color_.get(), size_);
+            }
+            load_plane(text_.get(), size_);
+            load_plane(mask8bit_.get(), size_of_mask8bit_);
+
+            uint32_t expected = crc.value();
+            uint8_t stored[4];
+            read_exact(file, stored, 4, crc);
+            if (get_le32(stored) != expected) throw std::runtime_error(std::string("CRC mismatch in text_image file."));
+        }
+
+    private:
+
+        // Sets the dimensions, keeping the planes
+        // if the size does not change
+
+        auto resize(const uint_type w, const uint_type h) -> void {
+            uint_type size = w * h;
+            if (!color_ || size != size_) {
+                size_of_mask8bit_ = size % 8 == 0 ? size / 8 : size / 8 + 1;
+                color_.reset(new color[size]);
+                text_.reset(new text[size]);
+                mask8bit_.reset(new mask8bit[size_of_mask8bit_]);
+            }
+            w_ = w;
+            h_ = h;
+            size_ = size;
+        }
+
+        // read holds the 4 bytes taken for the magic. With an 8-bit
+        // uint_type the header is 2 bytes, so the other 2 already
+        // belong to the planes
+
+        auto load_unversioned(std::istream &file, const uint8_t *read) -> void {
+            crc32 ignored;
+            uint8_t dims[2 * sizeof(uint_type) > 4 ? 2 * sizeof(uint_type) : 4];
+            std::memcpy(dims, read, 4);
+            if (2 * sizeof(uint_type) > 4) read_exact(file, dims + 4, 2 * sizeof(uint_type) - 4, ignored);
+
+            uint_type w, h;
+            std::memcpy(&w, dims, sizeof(w));
+            std::memcpy(&h, dims + sizeof(w), sizeof(h));
+            resize(validator_if_less_than<uint_type, 1>(w), validator_if_less_than<uint_type, 1>(h));
+
+            const uint8_t *extra = read + 2 * sizeof(uint_type);
+            std::size_t size_of_extra = 2 * sizeof(uint_type) < 4 ? 4 - 2 * sizeof(uint_type) : 0;
+            auto load_plane = [&](uint8_t *to, const std::size_t n) {
+                std::size_t k = size_of_extra < n ? size_of_extra : n;
+                std::memcpy(to, extra, k);
+                extra += k;
+                size_of_extra -= k;
+                read_exact(file, to + k, n - k, ignored);
+            };
+
+            load_plane(color_.get(), size_);
+            load_plane(text_.get(), size_);
+            load_plane(mask8bit_.get(), size_of_mask8bit_);
+        }
+
+    public:
+
         auto show() const -> void {
-            static const std::string color[] { "\033[30m", "\033[31m", "\033[32m", "\033[33m", "\033[34m", "\033[35m", "\033[36m", "\033[37m" };
-            static const uint_type size_of_color = sizeof(color) / sizeof(std::string);
-            std::stringstream output;
+            text_output &output = show_output(esc_clear_screen.size + esc_reset_attrib.size + 1 + size_ * (esc_color[0].size + 1) + h_);
             
-            output << "\033[2J";
-            uint_type prev_color = size_of_color;
+            output.append(esc_clear_screen);
+            uint_type prev_color = size_of_esc_color;
             uint_type next_line = w_;
             for (uint_type i = 0; i < size_; ++i) {
-                if (prev_color != color_[i]) {prev_color = color_[i]; output << color[prev_color];}
-                if (i == next_line) {output << "\n"; next_line += w_;} 
-                output << text_[i];
+                color c = color_[i] % size_of_esc_color;
+                if (prev_color != c) {prev_color = c; output.append(esc_color[prev_color]);}
+                if (i == next_line) {output.push_back('\n'); next_line += w_;} 
+                output.push_back(static_cast<char>(text_[i]));
             }
 
-            output << "\033[0m\n";
-            std::cout << output.str();            
+            output.append(esc_reset_attrib);
+            output.push_back('\n');
+            output.flush();
         }
     };
 }
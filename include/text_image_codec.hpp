@@ -0,0 +1,200 @@
+/**
+ * @file text_image_codec.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Run-length coding, CRC-32 and little-endian fields for the text_image file format
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * File layout, all fields little-endian:
+ *
+ *  magic       4   "TXIM"
+ *  version     1   1
+ *  flags       1   FORMAT_COLOR_4BIT if colors are packed 2 per byte,
+ *                  FORMAT_RAW if the planes are stored as they are
+ *  reserved    2   0
+ *  width       4
+ *  height      4
+ *  per plane, color, text then mask:
+ *    length    4   bytes of run-length code that follow
+ *    code      length  (the plane itself if FORMAT_RAW)
+ *  crc         4   CRC-32 of everything before it
+ *
+ * Run-length code is a series of packets, each led by a control byte c:
+ *
+ *  c < 128     c + 1 literal bytes follow
+ *  c >= 128    the next byte repeats c - 128 + 3 times
+ *
+ * Runs shorter than 3 are cheaper as literals, so the worst case grows a
+ * plane by one byte in 128.
+ *
+ * Raw images are larger but their planes can be used in place, e.g.
+ * from a file mapped into memory by text_image_map.
+ *
+ */
+
+#ifndef TEXT_IMAGE_CODEC_HPP
+#define TEXT_IMAGE_CODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace g80 {
+
+    constexpr char text_image_magic[4] {'T', 'X', 'I', 'M'};
+    constexpr uint8_t text_image_version = 1;
+    enum text_image_format_flag : uint8_t {FORMAT_COLOR_4BIT = 0x01, FORMAT_RAW = 0x02};
+    enum text_image_encoding {ENCODE_RLE, ENCODE_RAW};
+
+    class crc32 {
+    public:
+
+        inline auto update(const void *data, const std::size_t n) -> void {
+            const uint8_t *p = static_cast<const uint8_t *>(data);
+            for (std::size_t i = 0; i < n; ++i) crc_ = table()[(crc_ ^ p[i]) & 0xff] ^ (crc_ >> 8);
+        }
+
+        inline auto value() const -> uint32_t {
+            return ~crc_;
+        }
+
+    private:
+
+        uint32_t crc_{0xffffffff};
+
+        static auto table() -> const std::array<uint32_t, 256> & {
+            static const std::array<uint32_t, 256> t = []() {
+                std::array<uint32_t, 256> t {};
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+                    t[i] = c;
+                }
+                return t;
+            }();
+            return t;
+        }
+    };
+
+    // Little-endian fields
+
+    inline auto append_le32(std::vector<char> &out, const uint32_t v) -> void {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+    }
+
+    inline auto patch_le32(std::vector<char> &out, const std::size_t at, const uint32_t v) -> void {
+        for (int i = 0; i < 4; ++i) out[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+    }
+
+    inline auto get_le32(const uint8_t *p) -> uint32_t {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline auto append_le64(std::vector<char> &out, const uint64_t v) -> void {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+    }
+
+    inline auto get_le64(const uint8_t *p) -> uint64_t {
+        return get_le32(p) | (static_cast<uint64_t>(get_le32(p + 4)) << 32);
+    }
+
+    // Reads n bytes into to, adding them to crc. The stream
+    // buffer is used directly, without a sentry per read
+
+    inline auto read_exact(std::istream &in, void *to, const std::size_t n, crc32 &crc) -> void {
+        if (static_cast<std::size_t>(in.rdbuf()->sgetn(static_cast<char *>(to), static_cast<std::streamsize>(n))) != n) {
+            in.setstate(std::ios::eofbit | std::ios::failbit);
+            throw std::runtime_error(std::string("Truncated text_image file."));
+        }
+        crc.update(to, n);
+    }
+
+    // Appends the run-length code of n bytes to out
+
+    inline auto rle_encode(const uint8_t *data, const std::size_t n, std::vector<char> &out) -> void {
+        static constexpr std::size_t max_literal = 128, min_run = 3, max_run = 130;
+
+        auto flush_literal = [&](std::size_t from, const std::size_t to) {
+            while (from < to) {
+                std::size_t len = to - from < max_literal ? to - from : max_literal;
+                out.push_back(static_cast<char>(len - 1));
+                out.insert(out.end(), data + from, data + from + len);
+                from += len;
+            }
+        };
+
+        std::size_t literal = 0, i = 0;
+        while (i < n) {
+            std::size_t run = 1;
+            while (i + run < n && run < max_run && data[i + run] == data[i]) ++run;
+
+            if (run >= min_run) {
+                flush_literal(literal, i);
+                out.push_back(static_cast<char>(128 + run - min_run));
+                out.push_back(static_cast<char>(data[i]));
+                literal = i + run;
+            }
+            i += run;
+        }
+        flush_literal(literal, n);
+    }
+
+    // Decodes length bytes of run-length code from in straight
+    // into the n bytes at to, adding the code read to crc
+
+    inline auto rle_decode(std::istream &in, uint8_t *to, const std::size_t n, const std::size_t length, crc32 &crc) -> void {
+        std::streambuf *buf = in.rdbuf();
+        std::size_t i = 0, read = 0;
+        while (read < length) {
+            int c = buf->sbumpc();
+            if (c == std::char_traits<char>::eof()) throw std::runtime_error(std::string("Truncated text_image file."));
+            uint8_t control = static_cast<uint8_t>(c);
+            crc.update(&control, 1);
+            ++read;
+
+            if (control < 128) {
+                std::size_t len = control + 1;
+                if (i + len > n || read + len > length) throw std::runtime_error(std::string("Corrupt text_image file."));
+                read_exact(in, to + i, len, crc);
+                read += len;
+                i += len;
+            } else {
+                std::size_t len = control - 128 + 3;
+                int v = buf->sbumpc();
+                if (v == std::char_traits<char>::eof()) throw std::runtime_error(std::string("Truncated text_image file."));
+                if (i + len > n || read + 1 > length) throw std::runtime_error(std::string("Corrupt text_image file."));
+                uint8_t value = static_cast<uint8_t>(v);
+                crc.update(&value, 1);
+                ++read;
+                std::memset(to + i, value, len);
+                i += len;
+            }
+        }
+        if (i != n) throw std::runtime_error(std::string("Corrupt text_image file."));
+    }
+}
+
+#endif
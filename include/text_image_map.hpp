@@ -0,0 +1,226 @@
+/**
+ * @file text_image_map.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Zero-copy access to a file of raw text_images mapped into memory
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * The file is one or more images saved back to back with ENCODE_RAW, e.g.
+ * an atlas of screens or the frames of text_frame_file. Opening it only
+ * maps the file. The header of an image is read the first time it or an
+ * image after it is asked for, to index where its planes are; the planes
+ * are never copied. Each image is handed out as a text_image_view into
+ * the mapping, which put_image() and the blits take like any other view,
+ * and pages are read in by the system the first time they are touched.
+ * size() indexes the whole file.
+ *
+ * Since the index grows on demand, a map is not to be shared between
+ * threads until size() has been called once.
+ *
+ *  MAP_READ_ONLY       shared, read-only pages: every process mapping
+ *                      the file uses the same physical copy
+ *  MAP_COPY_ON_WRITE   private pages that may be written through the
+ *                      raw_ pointers; a page is copied on its first
+ *                      write and the file itself never changes
+ *
+ * The CRC is not checked on open, since that would read every page. Call
+ * verify() for the images that need it.
+ *
+ */
+
+#ifndef TEXT_IMAGE_MAP_HPP
+#define TEXT_IMAGE_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "text_image.hpp"
+
+namespace g80 {
+
+    enum text_image_map_mode {MAP_READ_ONLY, MAP_COPY_ON_WRITE};
+
+    template<typename int_type, typename uint_type>
+    class text_image_map {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_image_map(const std::string &filename, const text_image_map_mode mode = MAP_READ_ONLY) : mode_(mode) {
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error(std::string("Unable to open ") + filename + ".");
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+                close(fd);
+                throw std::runtime_error(std::string("Unable to map ") + filename + ".");
+            }
+            size_of_data_ = static_cast<std::size_t>(st.st_size);
+
+            void *data = mode_ == MAP_READ_ONLY ?
+                mmap(nullptr, size_of_data_, PROT_READ, MAP_SHARED, fd, 0) :
+                mmap(nullptr, size_of_data_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) throw std::runtime_error(std::string("Unable to map ") + filename + ".");
+            data_ = static_cast<uint8_t *>(data);
+        }
+
+        text_image_map(const text_image_map &) = delete;
+        auto operator=(const text_image_map &) -> text_image_map & = delete;
+
+        text_image_map(text_image_map &&rhs) :
+            mode_(rhs.mode_), data_(rhs.data_), size_of_data_(rhs.size_of_data_),
+            images_(std::move(rhs.images_)), next_offset_(rhs.next_offset_) {
+
+            rhs.data_ = nullptr;
+            rhs.size_of_data_ = 0;
+        }
+
+        ~text_image_map() {
+            if (data_) munmap(data_, size_of_data_);
+        }
+
+    private:
+
+        struct image {
+            std::size_t offset, color, text, mask8bit, end;
+            uint_type w, h, size_of_mask8bit;
+        };
+
+        text_image_map_mode mode_;
+        uint8_t *data_{nullptr};
+        std::size_t size_of_data_{0};
+        mutable std::vector<image> images_;
+        mutable std::size_t next_offset_{0};
+
+    // Getters
+
+    public:
+
+        auto size() const -> std::size_t {
+            while (next_offset_ < size_of_data_) index_next();
+            return images_.size();
+        }
+
+        inline auto mode() const -> text_image_map_mode {
+            return mode_;
+        }
+
+        inline auto width(const std::size_t i) const -> uint_type {
+            return get_image(i).w;
+        }
+
+        inline auto height(const std::size_t i) const -> uint_type {
+            return get_image(i).h;
+        }
+
+        auto view(const std::size_t i) const -> text_image_view<int_type, uint_type> {
+            const image &img = get_image(i);
+            return text_image_view<int_type, uint_type>(
+                data_ + img.text, data_ + img.color, data_ + img.mask8bit, 0, img.w, img.w, img.h);
+        }
+
+        // Writable planes, only for MAP_COPY_ON_WRITE
+
+        inline auto raw_text(const std::size_t i) -> text * {
+            return writable(get_image(i).text);
+        }
+
+        inline auto raw_color(const std::size_t i) -> color * {
+            return writable(get_image(i).color);
+        }
+
+        inline auto raw_mask8bit(const std::size_t i) -> mask8bit * {
+            return writable(get_image(i).mask8bit);
+        }
+
+        // Checks the CRC of image i, which reads all of its pages
+
+        auto verify(const std::size_t i) const -> bool {
+            const image &img = get_image(i);
+            crc32 crc;
+            crc.update(data_ + img.offset, img.end - img.offset);
+            return crc.value() == get_le32(data_ + img.end);
+        }
+
+    private:
+
+        inline auto writable(const std::size_t offset) -> uint8_t * {
+            if (mode_ != MAP_COPY_ON_WRITE) throw std::runtime_error(std::string("The text_image_map is read-only."));
+            return data_ + offset;
+        }
+
+        auto get_image(const std::size_t i) const -> const image & {
+            while (i >= images_.size() && next_offset_ < size_of_data_) index_next();
+            if (i >= images_.size()) throw std::out_of_range(std::string("No such image in the text_image_map."));
+            return images_[i];
+        }
+
+        // Reads the header of the image at next_offset_
+
+        auto index_next() const -> void {
+            auto corrupt = []() {throw std::runtime_error(std::string("Corrupt or compressed text_image file, only ENCODE_RAW files can be mapped."));};
+
+            std::size_t at = next_offset_;
+
+            if (size_of_data_ - at < 16) corrupt();
+            const uint8_t *header = data_ + at;
+            if (std::memcmp(header, text_image_magic, 4) != 0 || header[4] != text_image_version || !(header[5] & FORMAT_RAW)) corrupt();
+
+            uint32_t w = get_le32(header + 8), h = get_le32(header + 12);
+            uint64_t size = static_cast<uint64_t>(w) * h;
+            if (w < 1 || h < 1 || size > static_cast<uint64_t>(static_cast<uint_type>(~static_cast<uint_type>(0)))) corrupt();
+
+            image img;
+            img.offset = at;
+            img.w = static_cast<uint_type>(w);
+            img.h = static_cast<uint_type>(h);
+            img.size_of_mask8bit = static_cast<uint_type>((size + 7) / 8);
+
+            // Each plane is its length followed by the plane
+            std::size_t next = at + 16;
+            auto plane = [&](const uint64_t n) -> std::size_t {
+                if (size_of_data_ - next < 4 || get_le32(data_ + next) != n || size_of_data_ - next - 4 < n) corrupt();
+                std::size_t start = next + 4;
+                next = start + static_cast<std::size_t>(n);
+                return start;
+            };
+            img.color = plane(size);
+            img.text = plane(size);
+            img.mask8bit = plane(img.size_of_mask8bit);
+
+            if (size_of_data_ - next < 4) corrupt();
+            img.end = next;
+            images_.push_back(img);
+            next_offset_ = next + 4;
+        }
+    };
+}
+
+#endif
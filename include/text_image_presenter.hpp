@@ -0,0 +1,220 @@
+/**
+ * @file text_image_presenter.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Presents text_image frames to the terminal on a thread of its own
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Frames are handed over through three slots. The caller owns the back
+ * slot and the presenter thread the front slot; the third sits in between
+ * and changes hands with a single atomic exchange, together with a bit
+ * telling whether it holds a frame not yet presented:
+ *
+ *  submit()    copy the frame into back, exchange back with the middle
+ *  presenter   if the middle is fresh, exchange front with it, present
+ *
+ * Neither side waits for the other. A slot is only ever touched by its
+ * owner, so a frame is presented whole or not at all. When the caller
+ * submits faster than the terminal takes frames, the older unpresented
+ * frame is replaced and counted as dropped.
+ *
+ * The mutex and condition variable only put an idle presenter to sleep,
+ * the handover itself does not take them.
+ *
+ */
+
+#ifndef TEXT_IMAGE_PRESENTER_HPP
+#define TEXT_IMAGE_PRESENTER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "text_image.hpp"
+#include "text_image_renderer.hpp"
+
+namespace g80 {
+
+    template<typename int_type, typename uint_type>
+    class text_image_presenter {
+
+    // Constructors and instance vars
+
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        text_image_presenter(text_image_renderer<int_type, uint_type> &renderer) : renderer_(renderer) {}
+
+        text_image_presenter(const text_image_presenter &) = delete;
+        auto operator=(const text_image_presenter &) -> text_image_presenter & = delete;
+
+        ~text_image_presenter() {
+            stop();
+        }
+
+    private:
+
+        static constexpr uint8_t index_mask_ = 0x03;
+        static constexpr uint8_t fresh_ = 0x04;
+
+        struct slot {
+            text_image<int_type, uint_type> screen;
+            clock::time_point submitted;
+        };
+
+        text_image_renderer<int_type, uint_type> &renderer_;
+        std::array<slot, 3> slots_;
+        uint8_t back_{0}, front_{1};
+        std::atomic<uint8_t> middle_{2};
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::atomic<bool> is_running_{false};
+
+        // Per frame stats, written by the presenter thread
+        std::atomic<uint64_t> frames_submitted_{0}, frames_presented_{0}, frames_dropped_{0};
+        std::atomic<uint64_t> latency_ns_{0}, present_ns_{0}, bytes_written_{0};
+
+    // Getters for frame statistics
+
+    public:
+
+        inline auto is_running() const -> bool {
+            return is_running_.load(std::memory_order_relaxed);
+        }
+
+        inline auto frames_submitted() const -> uint64_t {
+            return frames_submitted_.load(std::memory_order_relaxed);
+        }
+
+        inline auto frames_presented() const -> uint64_t {
+            return frames_presented_.load(std::memory_order_relaxed);
+        }
+
+        // Frames replaced by a newer one before being presented
+
+        inline auto frames_dropped() const -> uint64_t {
+            return frames_dropped_.load(std::memory_order_relaxed);
+        }
+
+        // From submit() to the end of the terminal write,
+        // of the last frame presented
+
+        inline auto latency() const -> std::chrono::nanoseconds {
+            return std::chrono::nanoseconds(latency_ns_.load(std::memory_order_relaxed));
+        }
+
+        // Time spent encoding and writing the last frame presented
+
+        inline auto present_time() const -> std::chrono::nanoseconds {
+            return std::chrono::nanoseconds(present_ns_.load(std::memory_order_relaxed));
+        }
+
+        inline auto bytes_written() const -> uint64_t {
+            return bytes_written_.load(std::memory_order_relaxed);
+        }
+
+    // Producer side
+
+    public:
+
+        // Sizes the slots after screen and starts the presenter thread
+
+        auto start(const text_image<int_type, uint_type> &screen) -> void {
+            stop();
+            for (auto &s : slots_) s.screen = screen;
+            back_ = 0;
+            front_ = 1;
+            middle_.store(2, std::memory_order_relaxed);
+            frames_submitted_ = frames_presented_ = frames_dropped_ = 0;
+            latency_ns_ = present_ns_ = bytes_written_ = 0;
+
+            is_running_.store(true, std::memory_order_relaxed);
+            thread_ = std::thread([this]() {present_loop();});
+        }
+
+        // Presents the last frame submitted, if
+        // it has not been yet, and joins the thread
+
+        auto stop() -> void {
+            if (!thread_.joinable()) return;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                is_running_.store(false, std::memory_order_relaxed);
+            }
+            cv_.notify_one();
+            thread_.join();
+        }
+
+        auto submit(const text_image<int_type, uint_type> &screen) -> void {
+            slot &s = slots_[back_];
+            s.screen = screen;
+            s.submitted = clock::now();
+
+            uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | fresh_), std::memory_order_acq_rel);
+            back_ = prev & index_mask_;
+            if (prev & fresh_) frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+            frames_submitted_.fetch_add(1, std::memory_order_relaxed);
+
+            // Taking the lock orders the handover before a
+            // presenter that is about to sleep checks for it
+            {std::lock_guard<std::mutex> lock(mutex_);}
+            cv_.notify_one();
+        }
+
+    // Consumer side
+
+    private:
+
+        auto present_loop() -> void {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [this]() {return is_fresh() || !is_running_.load(std::memory_order_relaxed);});
+                }
+                if (!is_fresh()) return;
+
+                front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask_;
+                const slot &s = slots_[front_];
+
+                clock::time_point start = clock::now();
+                renderer_.present(s.screen);
+                clock::time_point end = clock::now();
+
+                present_ns_.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()), std::memory_order_relaxed);
+                latency_ns_.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - s.submitted).count()), std::memory_order_relaxed);
+                bytes_written_.fetch_add(renderer_.bytes_written(), std::memory_order_relaxed);
+                frames_presented_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline auto is_fresh() const -> bool {
+            return middle_.load(std::memory_order_acquire) & fresh_;
+        }
+    };
+}
+
+#endif
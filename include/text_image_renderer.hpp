@@ -0,0 +1,184 @@
+/**
+ * @file text_image_renderer.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief A differential presenter that only emits the cells of a text_image that changed since the last frame.
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * The renderer keeps a copy of the text and color planes it presented last.
+ * Each call to present() walks the new planes against the previous ones row
+ * by row and emits a cursor move followed by the changed run only. Unchanged
+ * gaps that are cheaper to re-emit than to jump over are merged into the run.
+ *
+ * The very first frame, a frame with different dimensions, or a frame after
+ * invalidate() is presented in full.
+ *
+ */
+
+#ifndef TEXT_IMAGE_RENDERER_HPP
+#define TEXT_IMAGE_RENDERER_HPP
+
+#include "text_image.hpp"
+#include "text_output.hpp"
+
+namespace g80 {
+
+    template<typename int_type, typename uint_type>
+    class text_image_renderer {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_image_renderer() = default;
+
+        ~text_image_renderer() = default;
+
+    // Getters for frame statistics
+
+    public:
+
+        inline auto bytes_written() const -> std::size_t {
+            return bytes_written_;
+        }
+
+        inline auto cells_changed() const -> uint_type {
+            return cells_changed_;
+        }
+
+        inline auto total_bytes_written() const -> std::size_t {
+            return total_bytes_written_;
+        }
+
+        inline auto frames() const -> std::size_t {
+            return frames_;
+        }
+
+    // Presenter
+
+    public:
+
+        auto invalidate() -> void {
+            is_valid_ = false;
+        }
+
+        auto present(const text_image<int_type, uint_type> &timg) -> void {
+            const text *curr_text = timg.craw_text_ptr().get();
+            const color *curr_color = timg.craw_color_ptr().get();
+
+            output_.clear();
+            cells_changed_ = 0;
+
+            if (!is_valid_ || w_ != timg.width() || h_ != timg.height()) {
+                reset(timg.width(), timg.height());
+                output_.append(esc_clear_screen);
+            }
+
+            uint_type term_color = size_of_esc_color;
+            for (uint_type row = 0; row < h_; ++row) {
+                uint_type start = row * w_;
+                uint_type end = start + w_;
+                uint_type i = start;
+                while (i < end) {
+
+                    // Skip unchanged cells
+                    if (is_valid_ && !is_changed(i, curr_text, curr_color)) {++i; continue;}
+
+                    // Extend the run while the unchanged gap
+                    // in between is cheaper than a cursor move
+                    uint_type run_end = i + 1;
+                    uint_type gap = 0;
+                    for (uint_type j = run_end; j < end && gap <= max_gap_; ++j) {
+                        if (!is_valid_ || is_changed(j, curr_text, curr_color)) {run_end = j + 1; gap = 0;}
+                        else ++gap;
+                    }
+
+                    output_.append_cursor(row, i - start);
+                    for (uint_type j = i; j < run_end; ++j) {
+                        color c = curr_color[j] % size_of_esc_color;
+                        if (term_color != c) {term_color = c; output_.append(esc_color[c]);}
+                        output_.push_back(static_cast<char>(curr_text[j]));
+                        if (!is_valid_ || is_changed(j, curr_text, curr_color)) {
+                            prev_text_[j] = curr_text[j];
+                            prev_color_[j] = curr_color[j];
+                            ++cells_changed_;
+                        }
+                    }
+
+                    i = run_end;
+                }
+            }
+
+            bytes_written_ = 0;
+            if (!output_.empty()) {
+                output_.append(esc_reset_attrib);
+                output_.append_cursor(h_, 0);
+                bytes_written_ = output_.flush();
+            }
+
+            is_valid_ = true;
+            total_bytes_written_ += bytes_written_;
+            ++frames_;
+        }
+
+    private:
+
+        auto reset(const uint_type w, const uint_type h) -> void {
+            if (w * h != size_) {
+                prev_color_.reset(new color[w * h]);
+                prev_text_.reset(new text[w * h]);
+            }
+            w_ = w;
+            h_ = h;
+            size_ = w * h;
+            is_valid_ = false;
+
+            // Worst case is a color change on every cell
+            // plus a cursor move on every row
+            output_.reserve(
+                esc_clear_screen.size + esc_reset_attrib.size + max_size_of_esc_cursor +
+                size_ * (esc_color[0].size + 1) + h_ * max_size_of_esc_cursor);
+        }
+
+        inline auto is_changed(const uint_type i, const text *curr_text, const color *curr_color) const -> bool {
+            return prev_text_[i] != curr_text[i] || prev_color_[i] != curr_color[i];
+        }
+
+    private:
+
+        // An unchanged gap longer than a typical
+        // cursor move sequence ends the run
+        static constexpr uint_type max_gap_ = 8;
+
+        uint_type w_{0}, h_{0}, size_{0};
+        uptr_color prev_color_{nullptr};
+        uptr_text prev_text_{nullptr};
+        text_output output_;
+        bool is_valid_{false};
+
+        uint_type cells_changed_{0};
+        std::size_t bytes_written_{0};
+        std::size_t total_bytes_written_{0};
+        std::size_t frames_{0};
+    };
+}
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file text_image_ring.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief A read-only copy of a text_image whose linear rotation costs O(1).
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Each plane is stored twice back to back, so every rotation of it is a
+ * contiguous window that starts at a virtual origin. Rotating only moves
+ * the origin of the rotated planes. Views taken from the ring read the
+ * rotated image directly and can be blitted like any text_image_view.
+ *
+ * Plane:   a b c d e | a b c d e
+ * Origin:      ^
+ * Reads:       b c d e   a        (rotated left by 1)
+ *
+ */
+
+#ifndef TEXT_IMAGE_RING_HPP
+#define TEXT_IMAGE_RING_HPP
+
+#include "text_image.hpp"
+
+namespace g80 {
+
+    template<typename int_type, typename uint_type>
+    class text_image_ring {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_image_ring() = default;
+
+        text_image_ring(const text_image<int_type, uint_type> &timg, const text_image_attrib tia = ALL) {
+            reset(timg, tia);
+        }
+
+        ~text_image_ring() = default;
+
+        auto reset(const text_image<int_type, uint_type> &timg, const text_image_attrib tia = ALL) -> void {
+            w_ = timg.width();
+            h_ = timg.height();
+            size_ = timg.size();
+            tia_ = tia;
+            text_origin_ = color_origin_ = mask_origin_ = 0;
+
+            std::size_t size_of_mask8bit = (2 * static_cast<std::size_t>(size_) + 7) / 8;
+            text_.reset(new text[2 * static_cast<std::size_t>(size_)]);
+            color_.reset(new color[2 * static_cast<std::size_t>(size_)]);
+            mask8bit_.reset(new mask8bit[size_of_mask8bit]);
+
+            for (std::size_t i = 0; i < 2; ++i) {
+                std::memcpy(&text_[i * size_], timg.craw_text_ptr().get(), sizeof(text) * size_);
+                std::memcpy(&color_[i * size_], timg.craw_color_ptr().get(), sizeof(color) * size_);
+                copy_mask_bits(mask8bit_.get(), i * size_, timg.craw_mask8bit_ptr().get(), 0, size_);
+            }
+        }
+
+    // Getters
+
+    public:
+
+        inline auto width() const -> uint_type {
+            return w_;
+        }
+
+        inline auto height() const -> uint_type {
+            return h_;
+        }
+
+        inline auto size() const -> uint_type {
+            return size_;
+        }
+
+    // Rotation, same semantics as text_image::xlat_rotate_*
+    // on the planes given at reset()
+
+    public:
+
+        auto rotate_left(const uint_type rotate) -> void {
+            move_origin(rotate % size_);
+        }
+
+        auto rotate_right(const uint_type rotate) -> void {
+            move_origin(size_ - rotate % size_);
+        }
+
+    // Views of the rotated image
+
+    public:
+
+        inline auto view() const -> text_image_view<int_type, uint_type> {
+            return get_image_view(0, 0, w_, h_);
+        }
+
+        auto get_image_view(const int_type x, const int_type y, const uint_type w, const uint_type h) const -> text_image_view<int_type, uint_type> {
+            int64_t sx = x, sy = y;
+            int64_t ex = sx + w, ey = sy + h;
+            if (sx < 0) sx = 0;
+            if (sy < 0) sy = 0;
+            if (ex > static_cast<int64_t>(w_)) ex = w_;
+            if (ey > static_cast<int64_t>(h_)) ey = h_;
+            if (ex <= sx || ey <= sy) return text_image_view<int_type, uint_type>();
+
+            std::size_t start = static_cast<std::size_t>(sy * w_ + sx);
+            return text_image_view<int_type, uint_type>(
+                &text_[text_origin_ + start], &color_[color_origin_ + start], mask8bit_.get(),
+                mask_origin_ + start, w_,
+                static_cast<uint_type>(ex - sx), static_cast<uint_type>(ey - sy));
+        }
+
+    private:
+
+        auto move_origin(const std::size_t n) -> void {
+            if (tia_ & TEXT) text_origin_ = (text_origin_ + n) % size_;
+            if (tia_ & COLOR) color_origin_ = (color_origin_ + n) % size_;
+            if (tia_ & MASK) mask_origin_ = (mask_origin_ + n) % size_;
+        }
+
+    private:
+
+        uint_type w_{0}, h_{0}, size_{0};
+        text_image_attrib tia_{ALL};
+        std::size_t text_origin_{0}, color_origin_{0}, mask_origin_{0};
+        uptr_text text_{nullptr};
+        uptr_color color_{nullptr};
+        uptr_mask8bit mask8bit_{nullptr};
+    };
+}
+
+#endif
@@ -0,0 +1,347 @@
+/**
+ * @file text_input.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Keyboard input for text_video_anim, read while the frame loop sleeps
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * wait_until() takes the place of the frame loop's sleep: it blocks in
+ * poll() on stdin until the deadline, so a key wakes the loop at once and
+ * an idle frame costs no syscall beyond the sleep it already had. Bytes
+ * are read only when poll() reports them and are decoded into a queue of
+ * keys, which next_key() pops without a syscall.
+ *
+ * Printable and control characters are their own key codes. Arrows,
+ * Home, End, Insert, Delete, Page Up/Down and F1 to F12 sent as escape
+ * sequences are decoded to the key_code values past 255. An escape that
+ * ends a read with nothing after it is the Esc key.
+ *
+ * open() switches a terminal to non-canonical mode without echo and
+ * close() restores it. SIGINT and SIGTERM restore it as well. Their
+ * handlers are installed with sigaction() on open() and the ones they
+ * replace are put back on close(). A signal the program ignores is left
+ * alone. A handler the program had set is chained to after the terminal
+ * is restored, and if it returns, the raw mode is set again. Otherwise
+ * the signal ends the program the way it would have.
+ *
+ */
+
+#ifndef TEXT_INPUT_HPP
+#define TEXT_INPUT_HPP
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace g80 {
+
+    enum key_code : int32_t {
+        KEY_NONE = -1,
+        KEY_ESCAPE = 27,
+        KEY_UP = 256, KEY_DOWN, KEY_RIGHT, KEY_LEFT,
+        KEY_HOME, KEY_END, KEY_INSERT, KEY_DELETE, KEY_PAGE_UP, KEY_PAGE_DOWN,
+        KEY_F1, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6,
+        KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12
+    };
+
+    class text_input {
+
+    // Constructors and instance vars
+
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        text_input(const int fd = STDIN_FILENO) : fd_(fd) {}
+
+        text_input(const text_input &) = delete;
+        auto operator=(const text_input &) -> text_input & = delete;
+
+        ~text_input() {
+            close();
+        }
+
+    private:
+
+        int fd_;
+        bool is_open_{false}, is_eof_{false}, is_raw_{false};
+        termios saved_term_;
+
+        // Bytes read but not decoded yet, i.e. a partial escape sequence
+        std::array<uint8_t, 256> bytes_;
+        std::size_t size_of_bytes_{0};
+
+        // Decoded keys, a ring of head_ to tail_
+        std::array<int32_t, 64> keys_;
+        std::size_t head_{0}, tail_{0};
+
+    // Opening and closing
+
+    public:
+
+        auto open() -> void {
+            if (is_open_) return;
+            is_open_ = true;
+            is_eof_ = false;
+            size_of_bytes_ = head_ = tail_ = 0;
+
+            if (isatty(fd_) && tcgetattr(fd_, &saved_term_) == 0) {
+                termios term = saved_term_;
+                term.c_lflag &= ~(ICANON | ECHO);
+                term.c_cc[VMIN] = 1;
+                term.c_cc[VTIME] = 0;
+                tcsetattr(fd_, TCSANOW, &term);
+                is_raw_ = true;
+                restore_on_signal(fd_, &saved_term_, &term);
+            }
+        }
+
+        auto close() -> void {
+            if (!is_open_) return;
+            if (is_raw_) {
+                tcsetattr(fd_, TCSANOW, &saved_term_);
+                restore_on_signal(-1, nullptr, nullptr);
+                is_raw_ = false;
+            }
+            is_open_ = false;
+        }
+
+    // Keys
+
+    public:
+
+        inline auto has_key() const -> bool {
+            return head_ != tail_;
+        }
+
+        // Next key decoded, or KEY_NONE
+
+        auto next_key() -> int32_t {
+            if (head_ == tail_) return KEY_NONE;
+            int32_t key = keys_[head_];
+            head_ = (head_ + 1) % keys_.size();
+            return key;
+        }
+
+        // Sleeps until the deadline or until a key is read,
+        // true if a key is waiting. An fd at its end or in
+        // error is not polled again, the frame just sleeps
+
+        auto wait_until(const clock::time_point deadline) -> bool {
+            if (has_key()) return true;
+            if (!is_open_ || is_eof_) {
+                std::this_thread::sleep_until(deadline);
+                return false;
+            }
+
+            for (;;) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count();
+                pollfd pfd {fd_, POLLIN, 0};
+                int ready = poll(&pfd, 1, left > 0 ? static_cast<int>(left) : 0);
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready == 0) return false;
+
+                if (ready < 0 || (pfd.revents & (POLLERR | POLLNVAL))) is_eof_ = true;
+                else read_available();
+
+                if (has_key()) return true;
+                if (is_eof_) {
+                    std::this_thread::sleep_until(deadline);
+                    return false;
+                }
+            }
+        }
+
+        // Reads whatever is waiting without blocking
+
+        auto poll_input() -> bool {
+            return wait_until(clock::now());
+        }
+
+    private:
+
+        auto read_available() -> void {
+            ssize_t n = read(fd_, bytes_.data() + size_of_bytes_, bytes_.size() - size_of_bytes_);
+            if (n == 0) {is_eof_ = true; return;}
+            if (n < 0) {
+                if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) is_eof_ = true;
+                return;
+            }
+            size_of_bytes_ += static_cast<std::size_t>(n);
+            decode();
+        }
+
+        auto push_key(const int32_t key) -> void {
+            std::size_t next = (tail_ + 1) % keys_.size();
+            if (next == head_) return;
+            keys_[tail_] = key;
+            tail_ = next;
+        }
+
+        auto decode() -> void {
+            std::size_t i = 0;
+            while (i < size_of_bytes_) {
+                uint8_t b = bytes_[i];
+                if (b != KEY_ESCAPE || i + 1 == size_of_bytes_) {
+                    push_key(b);
+                    ++i;
+                    continue;
+                }
+
+                // ESC [ or ESC O run up to a final byte in @..~,
+                // any other ESC x is Esc followed by x
+                uint8_t intro = bytes_[i + 1];
+                if (intro != '[' && intro != 'O') {
+                    push_key(KEY_ESCAPE);
+                    ++i;
+                    continue;
+                }
+
+                std::size_t j = i + 2;
+                while (j < size_of_bytes_ && (bytes_[j] < '@' || bytes_[j] > '~')) ++j;
+
+                // The rest of the sequence is still on its way
+                if (j == size_of_bytes_) {
+                    if (i == 0 && size_of_bytes_ == bytes_.size()) {size_of_bytes_ = 0; return;}
+                    break;
+                }
+
+                int32_t key = decode_sequence(intro, &bytes_[i + 2], &bytes_[j]);
+                if (key != KEY_NONE) push_key(key);
+                i = j + 1;
+            }
+
+            std::size_t left = size_of_bytes_ - i;
+            for (std::size_t k = 0; k < left; ++k) bytes_[k] = bytes_[i + k];
+            size_of_bytes_ = left;
+        }
+
+        // Key of ESC intro params final, where the final
+        // byte is at end and the params before it
+
+        static auto decode_sequence(const uint8_t intro, const uint8_t *params, const uint8_t *end) -> int32_t {
+            switch (*end) {
+                case 'A': return KEY_UP;
+                case 'B': return KEY_DOWN;
+                case 'C': return KEY_RIGHT;
+                case 'D': return KEY_LEFT;
+                case 'H': return KEY_HOME;
+                case 'F': return KEY_END;
+                case 'P': return intro == 'O' ? KEY_F1 : KEY_NONE;
+                case 'Q': return intro == 'O' ? KEY_F2 : KEY_NONE;
+                case 'R': return intro == 'O' ? KEY_F3 : KEY_NONE;
+                case 'S': return intro == 'O' ? KEY_F4 : KEY_NONE;
+                case '~': break;
+                default: return KEY_NONE;
+            }
+
+            int32_t n = 0;
+            for (const uint8_t *p = params; p < end && *p >= '0' && *p <= '9'; ++p) n = n * 10 + (*p - '0');
+
+            switch (n) {
+                case 1: case 7: return KEY_HOME;
+                case 2: return KEY_INSERT;
+                case 3: return KEY_DELETE;
+                case 4: case 8: return KEY_END;
+                case 5: return KEY_PAGE_UP;
+                case 6: return KEY_PAGE_DOWN;
+                case 11: return KEY_F1;
+                case 12: return KEY_F2;
+                case 13: return KEY_F3;
+                case 14: return KEY_F4;
+                case 15: return KEY_F5;
+                case 17: return KEY_F6;
+                case 18: return KEY_F7;
+                case 19: return KEY_F8;
+                case 20: return KEY_F9;
+                case 21: return KEY_F10;
+                case 23: return KEY_F11;
+                case 24: return KEY_F12;
+                default: return KEY_NONE;
+            }
+        }
+
+        // Restores the terminal to term on SIGINT and SIGTERM and
+        // chains to the handlers they had; fd < 0 puts those back
+
+        static auto restore_on_signal(const int fd, const termios *term, const termios *raw_term) -> void {
+            static int signal_fd = -1;
+            static termios signal_term, signal_raw_term;
+            static const int signals[] {SIGINT, SIGTERM};
+            static struct sigaction saved_actions[2];
+            static bool is_installed[2] {false, false};
+
+            if (fd < 0) {
+                for (int i = 0; i < 2; ++i) {
+                    if (is_installed[i]) sigaction(signals[i], &saved_actions[i], nullptr);
+                    is_installed[i] = false;
+                }
+                signal_fd = -1;
+                return;
+            }
+
+            signal_fd = fd;
+            signal_term = *term;
+            signal_raw_term = *raw_term;
+
+            struct sigaction action {};
+            action.sa_sigaction = +[](int sig, siginfo_t *info, void *context) {
+                int saved_errno = errno;
+                tcsetattr(signal_fd, TCSANOW, &signal_term);
+
+                const struct sigaction &saved = saved_actions[sig == SIGINT ? 0 : 1];
+                if (saved.sa_flags & SA_SIGINFO) {
+                    saved.sa_sigaction(sig, info, context);
+                } else if (saved.sa_handler != SIG_DFL && saved.sa_handler != SIG_IGN) {
+                    saved.sa_handler(sig);
+                } else {
+                    struct sigaction default_action {};
+                    default_action.sa_handler = SIG_DFL;
+                    sigemptyset(&default_action.sa_mask);
+                    sigaction(sig, &default_action, nullptr);
+                    raise(sig);
+                    return;
+                }
+
+                tcsetattr(signal_fd, TCSANOW, &signal_raw_term);
+                errno = saved_errno;
+            };
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+
+            for (int i = 0; i < 2; ++i) {
+                if (is_installed[i]) continue;
+                struct sigaction current;
+                if (sigaction(signals[i], nullptr, &current) != 0 || current.sa_handler == SIG_IGN) continue;
+                saved_actions[i] = current;
+                is_installed[i] = sigaction(signals[i], &action, nullptr) == 0;
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file text_output.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief A reusable, preallocated byte buffer for terminal output that is flushed with a single write(2).
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * The buffer only allocates when it has to grow. Callers that know the
+ * worst case size of a frame reserve() it once, after which building and
+ * flushing a frame costs zero heap allocations.
+ *
+ */
+
+#ifndef TEXT_OUTPUT_HPP
+#define TEXT_OUTPUT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <unistd.h>
+
+namespace g80 {
+
+    /**
+     * Escape sequences precomputed
+     * as fixed byte spans
+     *
+     */
+
+    struct text_span {
+        const char *data;
+        std::size_t size;
+    };
+
+    template<std::size_t N>
+    constexpr auto make_text_span(const char (&s)[N]) -> text_span {
+        return {s, N - 1};
+    }
+
+    constexpr text_span esc_clear_screen = make_text_span("\033[2J");
+    constexpr text_span esc_reset_attrib = make_text_span("\033[0m");
+    constexpr text_span esc_color[] {
+        make_text_span("\033[30m"), make_text_span("\033[31m"), make_text_span("\033[32m"), make_text_span("\033[33m"),
+        make_text_span("\033[34m"), make_text_span("\033[35m"), make_text_span("\033[36m"), make_text_span("\033[37m")};
+    constexpr std::size_t size_of_esc_color = sizeof(esc_color) / sizeof(text_span);
+
+    // Longest cursor move: "\033[" + 20 digits + ";" + 20 digits + "H"
+    constexpr std::size_t max_size_of_esc_cursor = 44;
+
+    /**
+     * Output buffer proper
+     *
+     */
+
+    class text_output {
+
+    // Constructors and instance vars
+
+    public:
+
+        text_output(const std::size_t capacity = 4096) :
+            capacity_(capacity),
+            buffer_(std::make_unique<char[]>(capacity_)) {}
+
+        text_output(const text_output &) = delete;
+        auto operator=(const text_output &) -> text_output & = delete;
+        ~text_output() = default;
+
+    // Getters
+
+    public:
+
+        inline auto data() const -> const char * {
+            return buffer_.get();
+        }
+
+        inline auto size() const -> std::size_t {
+            return size_;
+        }
+
+        inline auto capacity() const -> std::size_t {
+            return capacity_;
+        }
+
+        inline auto empty() const -> bool {
+            return size_ == 0;
+        }
+
+    // Buffer operations
+
+    public:
+
+        auto reserve(const std::size_t capacity) -> void {
+            if (capacity <= capacity_) return;
+            std::unique_ptr<char[]> buffer = std::make_unique<char[]>(capacity);
+            std::memcpy(buffer.get(), buffer_.get(), size_);
+            buffer_ = std::move(buffer);
+            capacity_ = capacity;
+        }
+
+        inline auto clear() -> void {
+            size_ = 0;
+        }
+
+        inline auto push_back(const char c) -> void {
+            if (size_ == capacity_) reserve(capacity_ * 2);
+            buffer_[size_++] = c;
+        }
+
+        inline auto append(const char *s, const std::size_t n) -> void {
+            if (size_ + n > capacity_) reserve(std::max(capacity_ * 2, size_ + n));
+            std::memcpy(&buffer_[size_], s, n);
+            size_ += n;
+        }
+
+        inline auto append(const text_span &s) -> void {
+            append(s.data, s.size);
+        }
+
+        auto append_uint(std::size_t n, const std::size_t width = 0, const std::size_t base = 10) -> void {
+            static const char digit[] = "0123456789abcdef";
+            char digits[24];
+            std::size_t d = 0;
+            do {digits[d++] = digit[n % base]; n /= base;} while (n > 0);
+            for (std::size_t i = d; i < width; ++i) push_back(' ');
+            while (d > 0) push_back(digits[--d]);
+        }
+
+        auto append_cursor(const std::size_t row, const std::size_t col) -> void {
+            append("\033[", 2);
+            append_uint(row + 1);
+            push_back(';');
+            append_uint(col + 1);
+            push_back('H');
+        }
+
+        // Writes the whole buffer to fd in one write(2)
+        // unless the kernel accepts it partially
+
+        auto flush(const int fd = STDOUT_FILENO) -> std::size_t {
+            std::fflush(stdout);
+            std::size_t written = 0;
+            while (written < size_) {
+                ssize_t n = ::write(fd, &buffer_[written], size_ - written);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                written += static_cast<std::size_t>(n);
+            }
+            size_ = 0;
+            return written;
+        }
+
+    private:
+
+        std::size_t capacity_{0};
+        std::size_t size_{0};
+        std::unique_ptr<char[]> buffer_{nullptr};
+    };
+}
+
+#endif
@@ -26,35 +26,18 @@
 #define TEXT_VIDEO_ANIM_HPP
 
 #include <chrono>
+#include <functional>
 #include <thread>
+#include "text_clip.hpp"
+#include "text_frame_clock.hpp"
 #include "text_image.hpp"
-
-#include <cstdio>
-#include <sys/select.h>
-#include <sys/ioctl.h>
-#include <termios.h>
+#include "text_image_presenter.hpp"
+#include "text_image_renderer.hpp"
+#include "text_input.hpp"
 
 namespace g80 {
 
     using namespace std::chrono;
-            
-    auto is_key_pressed() -> int {
-        static const int STDIN = 0;
-        static bool initialized = false;
-
-        if (!initialized) {
-            termios term;
-            tcgetattr(STDIN, &term);
-            term.c_lflag &= ~(ICANON | ECHO);
-            tcsetattr(STDIN, TCSANOW, &term);
-            setbuf(stdin, NULL);
-            initialized = true;
-        }
-
-        int bytes_waiting;
-        ioctl(STDIN, FIONREAD, &bytes_waiting); 
-        return bytes_waiting;
-    }
 
     template<typename int_type, typename uint_type>
     class text_video_anim {
@@ -65,7 +48,7 @@ namespace g80 {
 
         text_video_anim(const uint_type w, const uint_type h, const uint_type fps, const color c = 7, const text t = ' ', const mask_bit m = ON) :
             screen_(w, h, c, t, m),
-            MSPF_(1000 / validator_if_less_than<uint_type, 1>(fps)) {}
+            frame_clock_(validator_if_less_than<uint_type, 1>(fps)) {}
 
         virtual ~text_video_anim() = default;
 
@@ -81,48 +64,152 @@ namespace g80 {
             return screen_;
         }
 
+        // In pipelined mode the renderer belongs to the
+        // presenter thread until run() returns
+
+        inline auto renderer() const -> const text_image_renderer<int_type, uint_type> & {
+            return renderer_;
+        }
+
+        // Latency and throughput of the pipelined mode
+
+        inline auto presenter() const -> const text_image_presenter<int_type, uint_type> & {
+            return presenter_;
+        }
+
+        // Overload policy, achieved fps and jitter
+
+        inline auto frame_clock() -> text_frame_clock & {
+            return frame_clock_;
+        }
+
+        inline auto frame_clock() const -> const text_frame_clock & {
+            return frame_clock_;
+        }
+
+        inline auto is_pipelined() const -> bool {
+            return is_pipelined_;
+        }
+
+        inline auto input() -> text_input & {
+            return input_;
+        }
+
+    // Setters
+
+    public:
+
+        // When pipelined, run() hands each frame to a presenter thread
+        // and goes on to the next update() while the frame is written
+
+        inline auto set_pipelined(const bool is_pipelined) -> void {
+            is_pipelined_ = is_pipelined;
+        }
+
+        // run() hands capture(frame, screen) every frame it presents,
+        // e.g. a text_clip_recorder to record the session
+
+        inline auto set_capture(std::function<void(std::size_t, const text_image<int_type, uint_type> &)> capture) -> void {
+            capture_ = std::move(capture);
+        }
+
     // Overridable functions
 
     protected:
 
         virtual auto update() -> bool {return true;}
         
+        // Any key ends run(), override to read
+        // input().next_key() for anything else
+
         virtual auto event() -> bool {
-            if (is_key_pressed()) {
+            if (input_.next_key() != KEY_NONE) {
                 is_running_ = false;
             }
             return is_running_;
         }
 
-    private:
-
-        auto delayer(time_point<system_clock> &start) -> void {
-            time_point<system_clock> end {system_clock::now()};
-            uint_type delay = MSPF_ - static_cast<uint_type>(duration_cast<milliseconds>(end - start).count());
-            if (delay > 0) std::this_thread::sleep_for(milliseconds(delay));
-        }
-
     public:
 
         virtual auto preprocess() -> bool {return true;}
         
+        // update() runs on a fixed timestep of 1 / fps,
+        // see text_frame_clock for how overruns are handled
+
         virtual auto run() -> bool {
             is_running_ = true;
+            input_.open();
+            if (is_pipelined_) presenter_.start(screen_);
+            frame_clock_.start();
+            std::size_t frame = 0;
             do {
-                time_point<system_clock> start {system_clock::now()};
-                screen_.show();
-                if (event()) {update(); delayer(start);}
+                if (is_pipelined_) presenter_.submit(screen_);
+                else renderer_.present(screen_);
+                if (capture_) capture_(frame++, screen_);
+                if (event()) {
+                    for (uint32_t n = frame_clock_.updates_due(); n > 0 && is_running_; --n) update();
+
+                    // A key pressed while the frame
+                    // waits goes to event() at once
+                    auto wait_for_input = [this](const text_frame_clock::clock::time_point t) -> bool {return input_.wait_until(t);};
+                    while (!frame_clock_.wait(wait_for_input) && event()) {}
+                }
             } while(is_running_);
+            presenter_.stop();
+            input_.close();
 
             return true;
         }
 
+        // Runs frames frames of update() as fast as they go, without
+        // the terminal, the frame clock or input. capture(frame, screen)
+        // gets each frame as run() would have presented it, frame 0
+        // being the screen left by preprocess(). Returns the frames run
+
+        template<typename capture_type>
+        auto run_headless(const std::size_t frames, capture_type &&capture) -> std::size_t {
+            is_running_ = true;
+            std::size_t frame = 0;
+            for (; frame < frames && is_running_; ++frame) {
+                capture(frame, static_cast<const text_image<int_type, uint_type> &>(screen_));
+                update();
+            }
+            is_running_ = false;
+            return frame;
+        }
+
+        auto run_headless(const std::size_t frames) -> std::size_t {
+            return run_headless(frames, [](const std::size_t, const text_image<int_type, uint_type> &) {});
+        }
+
+        // Presents the frames of clip from its position on through
+        // the renderer, as fast as it takes them and without the frame
+        // clock, until the end of the clip or a key. Returns the frames
+        // presented
+
+        auto play(text_clip_player<int_type, uint_type> &clip) -> std::size_t {
+            if (clip.frames() == 0) return 0;
+            input_.open();
+            renderer_.invalidate();
+            std::size_t frames = 0;
+            do {
+                renderer_.present(clip.frame());
+                ++frames;
+            } while (!input_.poll_input() && clip.next());
+            input_.close();
+            return frames;
+        }
 
 
     protected:
         text_image<int_type, uint_type> screen_;
-        uint_type MSPF_;
+        text_image_renderer<int_type, uint_type> renderer_;
+        text_image_presenter<int_type, uint_type> presenter_{renderer_};
+        text_frame_clock frame_clock_;
+        text_input input_;
         bool is_running_{false};
+        bool is_pipelined_{false};
+        std::function<void(std::size_t, const text_image<int_type, uint_type> &)> capture_;
         
     };
 }
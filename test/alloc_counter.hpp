@@ -0,0 +1,81 @@
+/**
+ * @file alloc_counter.hpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Replaces the global operator new and delete with versions that count allocations
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * @note:
+ *
+ * Include it in exactly one translation unit of a test program, i.e. its
+ * main .cpp. Every operator new of the program then adds to
+ * allocations(), so a test can take it before and after the code that
+ * must not allocate.
+ *
+ */
+
+#ifndef ALLOC_COUNTER_HPP
+#define ALLOC_COUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace g80 {
+
+    inline auto allocation_counter() -> std::atomic<std::size_t> & {
+        static std::atomic<std::size_t> count {0};
+        return count;
+    }
+
+    inline auto allocations() -> std::size_t {
+        return allocation_counter().load(std::memory_order_relaxed);
+    }
+
+    inline auto counted_alloc(const std::size_t n) -> void * {
+        allocation_counter().fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(n ? n : 1);
+    }
+}
+
+auto operator new(std::size_t n) -> void * {
+    if (void *p = g80::counted_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t n) -> void * {
+    if (void *p = g80::counted_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+auto operator new(std::size_t n, const std::nothrow_t &) noexcept -> void * {
+    return g80::counted_alloc(n);
+}
+
+auto operator new[](std::size_t n, const std::nothrow_t &) noexcept -> void * {
+    return g80::counted_alloc(n);
+}
+
+auto operator delete(void *p) noexcept -> void {std::free(p);}
+auto operator delete[](void *p) noexcept -> void {std::free(p);}
+auto operator delete(void *p, std::size_t) noexcept -> void {std::free(p);}
+auto operator delete[](void *p, std::size_t) noexcept -> void {std::free(p);}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file gol_alloc_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Checks that a steady-state gol_hash generation makes no heap allocation
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "alloc_counter.hpp"
+#include "../demo/gol_hash.hpp"
+
+using namespace g80;
+
+/**
+ * The scratch buffers of gol_hash grow during the first
+ * generations, after which step() must not allocate
+ *
+ */
+
+constexpr uint_type WIDTH = 130;
+constexpr uint_type HEIGHT = 30;
+constexpr uint_type CREATURES = 2000;
+constexpr std::size_t WARM_UP_GENERATIONS = 10;
+constexpr std::size_t GENERATIONS = 1000;
+
+template<gol_topology topology>
+auto allocations_per_run(const char *name) -> std::size_t {
+    std::mt19937 rng(1);
+    std::vector<uint_type> cells(WIDTH * HEIGHT);
+    for (uint_type i = 0; i < cells.size(); ++i) cells[i] = i;
+    std::shuffle(cells.begin(), cells.end(), rng);
+    cells.resize(CREATURES);
+
+    gol_hash<WIDTH, HEIGHT, topology> engine(WIDTH, HEIGHT);
+    engine.reset(cells);
+    for (std::size_t i = 0; i < WARM_UP_GENERATIONS; ++i) engine.step();
+
+    std::size_t before = allocations();
+    for (std::size_t i = 0; i < GENERATIONS; ++i) engine.step();
+    std::size_t count = allocations() - before;
+
+    std::fprintf(stderr, "%s: %zu allocations in %zu generations, %u creatures left\n", name, count, GENERATIONS, static_cast<unsigned>(engine.size()));
+    return count;
+}
+
+auto main() -> int {
+    std::size_t count =
+        allocations_per_run<BOUNDED>("BOUNDED") +
+        allocations_per_run<TORUS>("TORUS") +
+        allocations_per_run<KLEIN>("KLEIN");
+    return count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file golden_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Compares headless runs of flag_demo and gol_demo against stored frames
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "../include/text_frame_capture.hpp"
+#include "../demo/flag.hpp"
+#include "../demo/gol.hpp"
+
+/**
+ * golden_test [--update] [dir]
+ *
+ * Runs flag and gol with seed 42 headless for FRAMES frames,
+ * keeps them in a text_frame_ring and compares the CRC-32 of
+ * each frame against dir/flag.crc and dir/gol.crc, one hex CRC
+ * per line. dir is test/golden by default, so run it from the
+ * repo root. --update writes the files from this run instead.
+ *
+ * The gol board is seeded through srand()/rand() and the flag
+ * wave through sin(), so the stored CRCs hold for the C library
+ * they were made with (glibc). Run --update after a change that
+ * is meant to alter the frames, and review the diff
+ *
+ */
+
+constexpr std::size_t FRAMES = 300;
+constexpr unsigned int GOL_SEED = 42;
+
+// Every plane of the frame and its size
+
+auto frame_crc(const text_image<int_type, uint_type> &frame) -> uint32_t {
+    uint32_t w = frame.width(), h = frame.height();
+    g80::crc32 crc;
+    crc.update(&w, sizeof(w));
+    crc.update(&h, sizeof(h));
+    crc.update(frame.craw_color_ptr().get(), frame.size());
+    crc.update(frame.craw_text_ptr().get(), frame.size());
+    crc.update(frame.craw_mask8bit_ptr().get(), frame.size_mask8bit());
+    return crc.value();
+}
+
+template<typename anim_type>
+auto run_crcs(anim_type &anim) -> std::vector<uint32_t> {
+    text_frame_ring<int_type, uint_type> ring(FRAMES);
+    anim.preprocess();
+    anim.run_headless(FRAMES, ring);
+
+    std::vector<uint32_t> crcs;
+    for (std::size_t f = 0; f < ring.captured(); ++f) crcs.push_back(frame_crc(ring.get_frame(f)));
+    return crcs;
+}
+
+auto check(const std::string &filename, const std::vector<uint32_t> &crcs, const bool update) -> bool {
+    if (update) {
+        std::ofstream out(filename);
+        for (auto crc : crcs) out << std::hex << std::setw(8) << std::setfill('0') << crc << '\n';
+        std::fprintf(stderr, "%s: %zu frames written\n", filename.c_str(), crcs.size());
+        return static_cast<bool>(out);
+    }
+
+    std::ifstream in(filename);
+    if (!in) {
+        std::fprintf(stderr, "%s: unable to open, run with --update to create it\n", filename.c_str());
+        return false;
+    }
+
+    std::vector<uint32_t> golden;
+    for (uint32_t crc; in >> std::hex >> crc;) golden.push_back(crc);
+    for (std::size_t f = 0; f < crcs.size() && f < golden.size(); ++f) {
+        if (crcs[f] != golden[f]) {
+            std::fprintf(stderr, "%s: frame %zu differs, %08x instead of %08x\n", filename.c_str(), f, crcs[f], golden[f]);
+            return false;
+        }
+    }
+    if (crcs.size() != golden.size()) {
+        std::fprintf(stderr, "%s: %zu frames instead of %zu\n", filename.c_str(), crcs.size(), golden.size());
+        return false;
+    }
+    std::fprintf(stderr, "%s: %zu frames ok\n", filename.c_str(), crcs.size());
+    return true;
+}
+
+auto main(const int argc, const char *argv[]) -> int {
+    bool update = argc >= 2 && std::string(argv[1]) == "--update";
+    std::string dir = argc >= 2 + update ? argv[1 + update] : "test/golden";
+
+    flag pinoy_flag;
+    gol game_of_life(GOL_SEED);
+    bool is_ok = check(dir + "/flag.crc", run_crcs(pinoy_flag), update);
+    is_ok &= check(dir + "/gol.crc", run_crcs(game_of_life), update);
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
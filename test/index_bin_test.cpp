@@ -0,0 +1,143 @@
+/**
+ * @file index_bin_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Randomized differential test of index_bin against std::set
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include "../demo/index.hpp"
+#include "../demo/index_bin.hpp"
+
+using namespace g80;
+
+/**
+ * Every operation is applied to an index_bin and to a std::set
+ * of the used indexes, then the whole state is compared: the
+ * used partition, the unused partition, is_used() and the sizes
+ *
+ */
+
+template<typename uint_type, std::size_t small_size>
+auto is_same_state(const index_bin<uint_type, small_size> &bin, const std::set<uint_type> &used, const std::size_t size) -> bool {
+    if (bin.size() != size || bin.size_of_used() != used.size() || bin.size_of_unused() != size - used.size()) return false;
+    if (bin.used().size() != used.size() || bin.unused().size() != size - used.size()) return false;
+    if (std::set<uint_type>(bin.used().begin(), bin.used().end()) != used) return false;
+    for (auto ix : bin.unused()) if (used.count(ix)) return false;
+
+    // Every index is in exactly one partition
+    std::set<uint_type> all(bin.used().begin(), bin.used().end());
+    all.insert(bin.unused().begin(), bin.unused().end());
+    if (all.size() != size) return false;
+
+    for (std::size_t ix = 0; ix < size; ++ix)
+        if (bin.is_used(static_cast<uint_type>(ix)) != (used.count(static_cast<uint_type>(ix)) > 0)) return false;
+    return !bin.is_used(static_cast<uint_type>(size));
+}
+
+template<typename uint_type, std::size_t small_size>
+auto test_index_bin(const char *name, const std::size_t size, const int operations, const unsigned int seed) -> bool {
+    std::mt19937 rng(seed);
+    std::size_t n = size;
+    index_bin<uint_type, small_size> bin(static_cast<uint_type>(n));
+    std::set<uint_type> used;
+
+    auto fail = [&](const int op, const char *what) {
+        std::fprintf(stderr, "%s: mismatch after %s, operation %d\n", name, what, op);
+        return false;
+    };
+
+    for (int op = 0; op < operations; ++op) {
+        uint_type ix = static_cast<uint_type>(rng() % (n + 1));
+        const char *what = "";
+        switch (rng() % 64) {
+            case 0:
+                what = "use_all";
+                bin.use_all();
+                for (std::size_t i = 0; i < n; ++i) used.insert(static_cast<uint_type>(i));
+                break;
+            case 1:
+                what = "unuse_all";
+                bin.unuse_all();
+                used.clear();
+                break;
+            case 2: {
+                what = "copy";
+                index_bin<uint_type, small_size> copy(bin);
+                if (!is_same_state(copy, used, n)) return fail(op, what);
+                bin = copy;
+                break;
+            }
+            case 3: {
+                what = "move";
+                index_bin<uint_type, small_size> moved(std::move(bin));
+                if (!is_same_state(moved, used, n)) return fail(op, what);
+                bin = std::move(moved);
+                break;
+            }
+            case 4:
+                what = "reset";
+                n = 1 + rng() % size;
+                bin.reset(static_cast<uint_type>(n));
+                used.clear();
+                break;
+            default:
+                if (rng() % 2) {
+                    what = "use";
+                    bool expected = ix < n && used.insert(ix).second;
+                    if (bin.use(ix) != expected) return fail(op, what);
+                } else {
+                    what = "unuse";
+                    bool expected = used.erase(ix) > 0;
+                    if (bin.unuse(ix) != expected) return fail(op, what);
+                }
+        }
+        if ((n <= 64 || op % 97 == 0) && !is_same_state(bin, used, n)) return fail(op, what);
+    }
+    std::fprintf(stderr, "%s: ok\n", name);
+    return true;
+}
+
+auto test_index() -> bool {
+    g80::index<uint16_t, 100> ix;
+    for (uint16_t i = 0; i < 100; ++i) ix.add_to_bin(i);
+    for (uint16_t i = 0; i < 100; i += 2) ix.remove_from_bin(i);
+
+    int sum = 0;
+    for (auto i : ix) sum += i;
+    bool is_ok = sum == 2500 && ix.size() == 50;
+    std::fprintf(stderr, "index: %s\n", is_ok ? "ok" : "mismatch");
+    return is_ok;
+}
+
+auto main() -> int {
+    bool is_ok = true;
+    is_ok &= test_index_bin<uint16_t, 0>("uint16_t, heap, 1000", 1000, 20000, 1);
+    is_ok &= test_index_bin<uint16_t, 64>("uint16_t, small 64, 50", 50, 20000, 2);
+    is_ok &= test_index_bin<uint16_t, 64>("uint16_t, small 64, 1000", 1000, 20000, 3);
+    is_ok &= test_index_bin<uint8_t, 16>("uint8_t, small 16, 200", 200, 20000, 4);
+    is_ok &= test_index_bin<uint32_t, 0>("uint32_t, heap, 100000", 100000, 2000, 5);
+    is_ok &= test_index();
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
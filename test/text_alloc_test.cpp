@@ -0,0 +1,93 @@
+/**
+ * @file text_alloc_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Checks that a steady-state frame of flag_demo and gol_demo makes no heap allocation
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "alloc_counter.hpp"
+#include "../demo/flag.hpp"
+#include "../demo/gol.hpp"
+
+/**
+ * Each frame is drawn by update(), then written with show()
+ * and with the renderer run() uses. Both write to fd 1,
+ * which is /dev/null for the test
+ *
+ */
+
+constexpr std::size_t WARM_UP_FRAMES = 10;
+constexpr std::size_t FRAMES = 200;
+
+template<typename anim_type>
+auto allocations_per_run(anim_type &anim) -> std::size_t {
+    text_image_renderer<int_type, uint_type> renderer;
+    std::size_t before = 0;
+    anim.preprocess();
+    anim.run_headless(WARM_UP_FRAMES + FRAMES, [&](const std::size_t frame, const text_image<int_type, uint_type> &screen) {
+        if (frame == WARM_UP_FRAMES) before = allocations();
+        screen.show();
+        renderer.present(screen);
+    });
+    return allocations() - before;
+}
+
+// Copies of an empty image, default constructed or from get_image()
+// wholly off the canvas, are empty and allocate nothing
+
+auto allocations_of_empty_copies() -> std::size_t {
+    text_image<int_type, uint_type> canvas(10, 5), empty;
+    text_image<int_type, uint_type> outside = canvas.get_image(20, 20, 3, 3);
+    std::size_t before = allocations();
+    text_image<int_type, uint_type> copy(empty), copy_of_outside(outside);
+    canvas = text_image<int_type, uint_type>(outside);
+    if (copy.size() != 0 || copy_of_outside.size() != 0 || canvas.size() != 0 || canvas.width() != 0) return ~std::size_t{0};
+    return allocations() - before;
+}
+
+auto main() -> int {
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0) {
+        std::fprintf(stderr, "Unable to send stdout to /dev/null.\n");
+        return EXIT_FAILURE;
+    }
+
+    flag pinoy_flag;
+    gol game_of_life(1);
+    std::size_t flag_allocations = allocations_per_run(pinoy_flag);
+    std::size_t gol_allocations = allocations_per_run(game_of_life);
+
+    std::size_t empty_copy_allocations;
+    try {
+        empty_copy_allocations = allocations_of_empty_copies();
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "empty copies: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::fprintf(stderr, "flag: %zu allocations in %zu frames\n", flag_allocations, FRAMES);
+    std::fprintf(stderr, "gol: %zu allocations in %zu frames\n", gol_allocations, FRAMES);
+    std::fprintf(stderr, "empty copies: %zu allocations\n", empty_copy_allocations);
+    return flag_allocations == 0 && gol_allocations == 0 && empty_copy_allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file text_clip_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Records clips with text_clip_recorder and plays them back, whole and damaged
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../include/text_clip.hpp"
+
+using namespace g80;
+using image = text_image<int16_t, uint16_t>;
+using recorder = text_clip_recorder<int16_t, uint16_t>;
+using player = text_clip_player<int16_t, uint16_t>;
+
+/**
+ * FRAMES frames, each a few random cells off the one before,
+ * are recorded with a keyframe every KEYFRAME_INTERVAL frames.
+ * The clip must play back frame for frame, in order with next()
+ * and out of order with seek(). With its trailer damaged or cut
+ * off, the player must fall back to walking the records and
+ * still find every whole frame. A damaged index or record must
+ * throw
+ *
+ */
+
+constexpr std::size_t FRAMES = 50;
+constexpr uint32_t KEYFRAME_INTERVAL = 7;
+
+auto make_frames() -> std::vector<image> {
+    std::mt19937 rng(1);
+    std::vector<image> frames;
+    image screen(40, 12, 0, '.', OFF);
+    for (std::size_t f = 0; f < FRAMES; ++f) {
+        for (int k = 0; k < 20; ++k) {
+            uint16_t i = static_cast<uint16_t>(rng() % screen.size());
+            screen.set_text(i, static_cast<text>('a' + rng() % 26));
+            screen.set_color(i, static_cast<color>(rng() % 16));
+            screen.set_mask(i, rng() % 2 ? ON : OFF);
+        }
+        frames.push_back(screen);
+    }
+    return frames;
+}
+
+auto is_same_image(const image &a, const image &b) -> bool {
+    if (a.width() != b.width() || a.height() != b.height()) return false;
+    for (uint16_t i = 0; i < a.size(); ++i)
+        if (a.get_text(i) != b.get_text(i) || a.get_color(i) != b.get_color(i) || a.get_mask(i) != b.get_mask(i)) return false;
+    return true;
+}
+
+auto temp_filename() -> std::string {
+    char name[] = "/tmp/text_clip_test_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd >= 0) close(fd);
+    return name;
+}
+
+auto read_file(const std::string &filename) -> std::string {
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+auto write_file(const std::string &filename, const std::string &bytes) -> void {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// The first n frames played with next(), then seek()
+// back and forth over them, from a fresh player
+
+auto is_playing(const std::string &filename, const std::vector<image> &frames, const std::size_t n) -> bool {
+    player clip(filename);
+    if (clip.frames() != n || clip.width() != 40 || clip.height() != 12 || clip.keyframe_interval() != KEYFRAME_INTERVAL) return false;
+
+    std::size_t played = 0;
+    do {
+        if (clip.position() != played || !is_same_image(clip.frame(), frames[played])) return false;
+        ++played;
+    } while (clip.next());
+    if (played != n) return false;
+
+    std::mt19937 rng(2);
+    for (int k = 0; k < 100; ++k) {
+        std::size_t f = rng() % n;
+        clip.seek(f);
+        if (clip.position() != f || !is_same_image(clip.frame(), frames[f])) return false;
+    }
+    return true;
+}
+
+template<typename F>
+auto is_throwing(F &&f) -> bool {
+    try {
+        f();
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+auto main() -> int {
+    const std::vector<image> frames = make_frames();
+    const std::string filename = temp_filename();
+    {
+        recorder rec(filename, KEYFRAME_INTERVAL);
+        for (std::size_t f = 0; f < FRAMES; ++f) rec(f, frames[f]);
+    }
+    const std::string bytes = read_file(filename);
+
+    bool is_ok = true;
+    auto check = [&](const char *name, const bool is_passed) {
+        std::fprintf(stderr, "%s: %s\n", name, is_passed ? "ok" : "mismatch");
+        is_ok &= is_passed;
+    };
+
+    check("record, play and seek", is_playing(filename, frames, FRAMES));
+
+    // The trailer's last byte at the end of the file, the index
+    // before it, its offset in the le64 16 bytes from the end
+    uint64_t at = 0;
+    for (int i = 0; i < 8; ++i) at |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[bytes.size() - 16 + i])) << (8 * i);
+
+    std::string damaged = bytes;
+    damaged[damaged.size() - 1] ^= 0x20;
+    write_file(filename, damaged);
+    check("damaged trailer, records walked", is_playing(filename, frames, FRAMES));
+
+    write_file(filename, bytes.substr(0, at));
+    check("no index, records walked", is_playing(filename, frames, FRAMES));
+
+    // Cut inside the record of the last frame
+    write_file(filename, bytes.substr(0, at - 3));
+    check("cut record, whole frames kept", is_playing(filename, frames, FRAMES - 1));
+
+    damaged = bytes;
+    damaged[at + 10] ^= 0x01;
+    write_file(filename, damaged);
+    check("damaged index", is_throwing([&]() {player clip(filename);}));
+
+    // A byte in the middle of the records: playing through
+    // from the start must hit the CRC of its record
+    damaged = bytes;
+    damaged[at / 2] ^= 0x01;
+    write_file(filename, damaged);
+    check("damaged record", is_throwing([&]() {player clip(filename); while (clip.next()) {}}));
+
+    std::remove(filename.c_str());
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
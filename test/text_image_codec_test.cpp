@@ -0,0 +1,199 @@
+/**
+ * @file text_image_codec_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Round trips of text_image::save() and load() through the TXIM codec
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "../include/text_image.hpp"
+
+using namespace g80;
+
+/**
+ * Images of random text, colors and masks are saved and loaded
+ * back, through a stream and through a file, and must come back
+ * cell for cell. Every truncation and a flipped byte in each part
+ * of a file must throw the codec's own error, not an iostream
+ * one. Files of the earlier, unversioned format are written by
+ * hand
+ *
+ */
+
+template<typename int_type, typename uint_type>
+auto random_image(const int_type w, const int_type h, const color max_color, const unsigned int seed) -> text_image<int_type, uint_type> {
+    std::mt19937 rng(seed);
+    text_image<int_type, uint_type> img(w, h);
+    for (uint_type i = 0; i < img.size(); ++i) {
+        img.set_text(i, static_cast<text>(rng() % 4 ? 'a' + rng() % 3 : rng() % 256));
+        img.set_color(i, static_cast<color>(rng() % (max_color + 1)));
+        img.set_mask(i, rng() % 2 ? ON : OFF);
+    }
+    return img;
+}
+
+template<typename int_type, typename uint_type>
+auto is_same_image(const text_image<int_type, uint_type> &a, const text_image<int_type, uint_type> &b) -> bool {
+    if (a.width() != b.width() || a.height() != b.height()) return false;
+    for (uint_type i = 0; i < a.size(); ++i)
+        if (a.get_text(i) != b.get_text(i) || a.get_color(i) != b.get_color(i) || a.get_mask(i) != b.get_mask(i)) return false;
+    return true;
+}
+
+auto report(const char *name, const bool is_ok) -> bool {
+    std::fprintf(stderr, "%s: %s\n", name, is_ok ? "ok" : "mismatch");
+    return is_ok;
+}
+
+auto temp_filename() -> std::string {
+    char name[] = "/tmp/text_image_codec_test_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd >= 0) close(fd);
+    return name;
+}
+
+auto write_file(const std::string &filename, const std::string &bytes) -> void {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// The error of loading bytes through both overloads, empty if
+// both load; an iostream error or a disagreement is reported
+
+template<typename int_type, typename uint_type>
+auto load_error(const std::string &bytes, const std::string &filename) -> std::string {
+    std::string errors[2];
+    for (int by_filename = 0; by_filename < 2; ++by_filename) {
+        text_image<int_type, uint_type> img;
+        try {
+            if (by_filename) {
+                write_file(filename, bytes);
+                img.load(filename);
+            } else {
+                std::istringstream in(bytes, std::ios::binary);
+                img.load(in);
+            }
+        } catch (const std::ios_base::failure &e) {
+            errors[by_filename] = std::string("iostream error ") + e.what();
+        } catch (const std::runtime_error &e) {
+            errors[by_filename] = e.what();
+        }
+    }
+    if (errors[0] != errors[1]) return "stream and file disagree: " + errors[0] + " / " + errors[1];
+    return errors[0];
+}
+
+template<typename int_type, typename uint_type>
+auto test_round_trip(const char *name, const int_type w, const int_type h, const color max_color, const text_image_encoding encoding) -> bool {
+    auto img = random_image<int_type, uint_type>(w, h, max_color, w * 31 + h);
+    std::ostringstream out(std::ios::binary);
+    img.save(out, encoding);
+    const std::string bytes = out.str();
+    const std::string filename = temp_filename();
+
+    auto fail = [&](const std::string &what) {
+        std::fprintf(stderr, "%s: %s\n", name, what.c_str());
+        std::remove(filename.c_str());
+        return false;
+    };
+
+    // 4-bit colors are packed unless the image is raw
+    bool is_color_4bit = encoding == ENCODE_RLE && max_color < 16;
+    if (bytes.size() < 6 || ((bytes[5] & FORMAT_COLOR_4BIT) != 0) != is_color_4bit ||
+        ((bytes[5] & FORMAT_RAW) != 0) != (encoding == ENCODE_RAW)) return fail("wrong format flags");
+
+    for (int by_filename = 0; by_filename < 2; ++by_filename) {
+        text_image<int_type, uint_type> loaded;
+        if (by_filename) {
+            img.save(filename, encoding);
+            loaded.load(filename);
+        } else {
+            std::istringstream in(bytes, std::ios::binary);
+            loaded.load(in);
+        }
+        if (!is_same_image(img, loaded)) return fail(by_filename ? "file differs" : "stream differs");
+    }
+
+    for (std::size_t n = 0; n < bytes.size(); n += 1 + n / 16) {
+        std::string error = load_error<int_type, uint_type>(bytes.substr(0, n), filename);
+        if (error != "Truncated text_image file.")
+            return fail("truncated to " + std::to_string(n) + " bytes: " + (error.empty() ? "loaded" : error));
+    }
+
+    // A flipped byte in the header, in each plane and in the CRC
+    for (std::size_t at : {std::size_t{9}, std::size_t{20}, bytes.size() / 2, bytes.size() - 10, bytes.size() - 1}) {
+        std::string corrupt = bytes;
+        corrupt[at] = static_cast<char>(corrupt[at] ^ 0x40);
+        std::string error = load_error<int_type, uint_type>(corrupt, filename);
+        if (error.empty() || error.compare(0, 15, "iostream error ") == 0 || error.compare(0, 6, "stream") == 0)
+            return fail("byte " + std::to_string(at) + " flipped: " + (error.empty() ? "loaded" : error));
+    }
+
+    std::remove(filename.c_str());
+    return report(name, true);
+}
+
+// The unversioned format: native w and h, then the raw planes
+
+template<typename int_type, typename uint_type>
+auto test_legacy(const char *name, const int_type w, const int_type h) -> bool {
+    auto img = random_image<int_type, uint_type>(w, h, 255, 1);
+    std::ostringstream out(std::ios::binary);
+    uint_type uw = img.width(), uh = img.height();
+    out.write(reinterpret_cast<const char *>(&uw), sizeof(uw));
+    out.write(reinterpret_cast<const char *>(&uh), sizeof(uh));
+    out.write(reinterpret_cast<const char *>(img.craw_color_ptr().get()), img.size());
+    out.write(reinterpret_cast<const char *>(img.craw_text_ptr().get()), img.size());
+    out.write(reinterpret_cast<const char *>(img.craw_mask8bit_ptr().get()), img.size_mask8bit());
+
+    std::istringstream in(out.str(), std::ios::binary);
+    text_image<int_type, uint_type> loaded;
+    try {
+        loaded.load(in);
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s: %s\n", name, e.what());
+        return false;
+    }
+    return report(name, is_same_image(img, loaded));
+}
+
+auto main() -> int {
+    bool is_ok = true;
+    is_ok &= test_round_trip<int16_t, uint16_t>("rle, 8-bit color, 130x30", 130, 30, 255, ENCODE_RLE);
+    is_ok &= test_round_trip<int16_t, uint16_t>("rle, 4-bit color, 130x30", 130, 30, 15, ENCODE_RLE);
+    is_ok &= test_round_trip<int16_t, uint16_t>("rle, 4-bit color, 7x3", 7, 3, 15, ENCODE_RLE);
+    is_ok &= test_round_trip<int16_t, uint16_t>("raw, 130x30", 130, 30, 15, ENCODE_RAW);
+    is_ok &= test_round_trip<int32_t, uint32_t>("rle, 4-bit color, 300x200", 300, 200, 7, ENCODE_RLE);
+    is_ok &= test_round_trip<int8_t, uint8_t>("raw, 1x1", 1, 1, 255, ENCODE_RAW);
+    is_ok &= test_legacy<int8_t, uint8_t>("legacy, uint8_t, 4x2", 4, 2);
+    is_ok &= test_legacy<int8_t, uint8_t>("legacy, uint8_t, 1x1", 1, 1);
+    is_ok &= test_legacy<int8_t, uint8_t>("legacy, uint8_t, 15x13", 15, 13);
+    is_ok &= test_legacy<int16_t, uint16_t>("legacy, uint16_t, 130x30", 130, 30);
+    is_ok &= test_legacy<int32_t, uint32_t>("legacy, uint32_t, 4x2", 4, 2);
+    is_ok &= test_legacy<int32_t, uint32_t>("legacy, uint32_t, 300x200", 300, 200);
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file text_image_map_test.cpp
+ * @author Everett Gaius S. Vergara (me@everettgaius.com)
+ * @brief Maps files of raw text_images and checks them against the images saved
+ * @version 0.1
+ * @date 2022-06-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../include/text_image_map.hpp"
+
+using namespace g80;
+using image = text_image<int16_t, uint16_t>;
+using image_map = text_image_map<int16_t, uint16_t>;
+
+/**
+ * Images of different sizes are saved back to back with
+ * ENCODE_RAW and mapped. Every view must match its image and
+ * pass verify(); a flipped plane byte must fail verify() for
+ * that image only. Compressed and truncated files must throw,
+ * and writes through a copy-on-write map must not reach the file
+ *
+ */
+
+auto random_image(const int16_t w, const int16_t h, std::mt19937 &rng) -> image {
+    image img(w, h);
+    for (uint16_t i = 0; i < img.size(); ++i) {
+        img.set_text(i, static_cast<text>('a' + rng() % 26));
+        img.set_color(i, static_cast<color>(rng() % 256));
+        img.set_mask(i, rng() % 2 ? ON : OFF);
+    }
+    return img;
+}
+
+auto is_same_image(const image &a, const image &b) -> bool {
+    if (a.width() != b.width() || a.height() != b.height()) return false;
+    for (uint16_t i = 0; i < a.size(); ++i)
+        if (a.get_text(i) != b.get_text(i) || a.get_color(i) != b.get_color(i) || a.get_mask(i) != b.get_mask(i)) return false;
+    return true;
+}
+
+auto temp_filename() -> std::string {
+    char name[] = "/tmp/text_image_map_test_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd >= 0) close(fd);
+    return name;
+}
+
+auto write_file(const std::string &filename, const std::string &bytes) -> void {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template<typename F>
+auto is_throwing(F &&f) -> bool {
+    try {
+        f();
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+auto main() -> int {
+    std::mt19937 rng(1);
+    const int16_t sizes[][2] {{130, 30}, {1, 1}, {7, 3}, {64, 2}, {33, 17}};
+    std::vector<image> images;
+    std::ostringstream raw(std::ios::binary), rle(std::ios::binary);
+    std::vector<std::size_t> ends;
+    for (auto size : sizes) {
+        images.push_back(random_image(size[0], size[1], rng));
+        images.back().save(raw, ENCODE_RAW);
+        images.back().save(rle, ENCODE_RLE);
+        ends.push_back(raw.str().size());
+    }
+    const std::string bytes = raw.str();
+    const std::string filename = temp_filename();
+    bool is_ok = true;
+    auto check = [&](const char *name, const bool is_passed) {
+        std::fprintf(stderr, "%s: %s\n", name, is_passed ? "ok" : "mismatch");
+        is_ok &= is_passed;
+    };
+
+    write_file(filename, bytes);
+    {
+        image_map map(filename);
+
+        // The last image first, before the file is indexed by size()
+        bool is_same = is_same_image(image(map.view(4)), images[4]);
+        is_same &= map.size() == images.size();
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            is_same &= map.width(i) == images[i].width() && map.height(i) == images[i].height();
+            is_same &= is_same_image(image(map.view(i)), images[i]) && map.verify(i);
+        }
+        check("map and verify", is_same);
+
+        bool is_out_of_range = false;
+        try {
+            map.view(images.size());
+        } catch (const std::out_of_range &) {
+            is_out_of_range = true;
+        }
+        check("past the last image", is_out_of_range);
+        check("read-only raw pointers", is_throwing([&]() {map.raw_text(0);}));
+    }
+
+    {
+        image_map map(filename, MAP_COPY_ON_WRITE);
+        map.raw_text(1)[0] = '#';
+        map.raw_color(1)[0] = 200;
+        bool is_written = map.view(1).text_ptr()[0] == '#' && !map.verify(1) && map.verify(0);
+        image_map reopened(filename);
+        check("copy on write", is_written && is_same_image(image(reopened.view(1)), images[1]));
+    }
+
+    {
+        // A text byte of image 2 flipped in the file
+        std::string corrupt = bytes;
+        std::size_t at = ends[1] + 16 + 4 + images[2].size() + 4;
+        corrupt[at] = static_cast<char>(corrupt[at] ^ 0x01);
+        write_file(filename, corrupt);
+        image_map map(filename);
+        check("verify of a flipped byte", map.verify(0) && map.verify(1) && !map.verify(2) && map.verify(3) && map.verify(4));
+    }
+
+    {
+        // Cut in the middle of image 3: the images before it
+        // still map, indexing past them throws
+        write_file(filename, bytes.substr(0, ends[2] + 20));
+        image_map map(filename);
+        bool is_partial = is_same_image(image(map.view(2)), images[2]) && map.verify(2);
+        check("truncated file", is_partial && is_throwing([&]() {map.size();}));
+    }
+
+    write_file(filename, rle.str());
+    check("compressed file", is_throwing([&]() {image_map map(filename); map.view(0);}));
+    check("missing file", is_throwing([&]() {image_map map(filename + ".none");}));
+
+    std::remove(filename.c_str());
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}